@@ -604,16 +604,16 @@ sai_object_id_t AclRuleL3::getRedirectObjectId(const string& redirect_value)
     string target = redirect_value.substr(colon_pos + 1);
 
     // Try to parse physical port and LAG first
-    Port port;
-    if(m_pAclOrch->m_portOrch->getPort(target, port))
+    Port *port = m_pAclOrch->m_portOrch->findPort(target);
+    if (port)
     {
-        if (port.m_type == Port::PHY)
+        if (port->m_type == Port::PHY)
         {
-            return port.m_port_id;
+            return port->m_port_id;
         }
-        else if (port.m_type == Port::LAG)
+        else if (port->m_type == Port::LAG)
         {
-            return port.m_lag_id;
+            return port->m_lag_id;
         }
         else
         {
@@ -1392,20 +1392,20 @@ bool AclOrch::processPorts(string portsList, ports_list_t& out)
 
     for (const auto& alias : strList)
     {
-        Port port;
-        if (!m_portOrch->getPort(alias, port))
+        Port *port = m_portOrch->findPort(alias);
+        if (!port)
         {
             SWSS_LOG_ERROR("Failed to process port. Port %s doesn't exist", alias.c_str());
             return false;
         }
 
-        if (port.m_type != Port::PHY)
+        if (port->m_type != Port::PHY)
         {
-            SWSS_LOG_ERROR("Failed to process port. Incorrect port %s type %d", alias.c_str(), port.m_type);
+            SWSS_LOG_ERROR("Failed to process port. Incorrect port %s type %d", alias.c_str(), port->m_type);
             return false;
         }
 
-        out.push_back(port.m_port_id);
+        out.push_back(port->m_port_id);
     }
 
     return true;
@@ -1556,6 +1556,14 @@ void AclOrch::collectCountersThread(AclOrch* pAclOrch)
 {
     SWSS_LOG_ENTER();
 
+    /* All counters of one pass are buffered and written in a single round trip */
+    swss::DBConnector db(COUNTERS_DB, DBConnector::DEFAULT_UNIXSOCKET, 0);
+    swss::RedisPipeline pipeline(&db);
+    swss::Table countersTable(&pipeline, "COUNTERS", true);
+    swss::Table sessionCountersTable(&pipeline, MIRROR_SESSION_COUNTERS_TABLE, true);
+
+    set<string> publishedSessions;
+
     while(m_bCollectCounters)
     {
         unique_lock<mutex> lock(m_countersMutex);
@@ -1563,24 +1571,53 @@ void AclOrch::collectCountersThread(AclOrch* pAclOrch)
         chrono::duration<double, milli> timeToSleep;
         auto  updStart = chrono::steady_clock::now();
 
-        for (auto table_it : pAclOrch->m_AclTables)
-        {
-            vector<swss::FieldValueTuple> values;
+        map<string, AclRuleCounters> sessionCounters;
 
-            for (auto rule_it : table_it.second.rules)
+        for (const auto& table_it : pAclOrch->m_AclTables)
+        {
+            for (const auto& rule_it : table_it.second.rules)
             {
                 AclRuleCounters cnt = rule_it.second->getCounters();
 
-                swss::FieldValueTuple fvtp("Packets", to_string(cnt.packets));
-                values.push_back(fvtp);
-                swss::FieldValueTuple fvtb("Bytes", to_string(cnt.bytes));
-                values.push_back(fvtb);
+                vector<swss::FieldValueTuple> values;
+                values.emplace_back("Packets", to_string(cnt.packets));
+                values.emplace_back("Bytes", to_string(cnt.bytes));
 
-                AclOrch::getCountersTable().set(table_it.second.id + ":" + rule_it.second->getId(), values, "");
+                countersTable.set(table_it.second.id + ":" + rule_it.second->getId(), values);
+
+                /* Mirror rules may live in both L3 and mirror tables */
+                auto rule = dynamic_pointer_cast<AclRuleMirror>(rule_it.second);
+                if (rule)
+                {
+                    sessionCounters[rule->getSessionName()] += cnt;
+                }
             }
-            values.clear();
         }
 
+        for (const auto& session : sessionCounters)
+        {
+            vector<swss::FieldValueTuple> values;
+            values.emplace_back("Packets", to_string(session.second.packets));
+            values.emplace_back("Bytes", to_string(session.second.bytes));
+
+            sessionCountersTable.set(session.first, values);
+            publishedSessions.erase(session.first);
+        }
+
+        /* Sessions which are not referenced by any rule anymore */
+        for (const auto& name : publishedSessions)
+        {
+            sessionCountersTable.del(name);
+        }
+
+        publishedSessions.clear();
+        for (const auto& session : sessionCounters)
+        {
+            publishedSessions.insert(session.first);
+        }
+
+        pipeline.flush();
+
         timeToSleep = chrono::seconds(COUNTERS_READ_INTERVAL) - (chrono::steady_clock::now() - updStart);
         if (timeToSleep > chrono::seconds(0))
         {
@@ -1620,12 +1657,11 @@ sai_status_t AclOrch::bindAclTable(sai_object_id_t table_oid, AclTable &aclTable
     {
         for (const auto& portOid : aclTable.ports)
         {
-            Port port;
-            gPortsOrch->getPort(portOid, port);
-            assert(port.m_type == Port::PHY);
+            Port *port = gPortsOrch->findPort(portOid);
+            assert(port && port->m_type == Port::PHY);
 
             sai_object_id_t group_member_oid;
-            status = port.bindAclTable(group_member_oid, table_oid);
+            status = port->bindAclTable(group_member_oid, table_oid);
             if (status != SAI_STATUS_SUCCESS) {
                 return status;
             }
@@ -208,6 +208,11 @@ public:
     void update(SubjectType, void *);
     AclRuleCounters getCounters();
 
+    string getSessionName() const
+    {
+        return m_sessionName;
+    }
+
 protected:
     bool m_state;
     string m_sessionName;
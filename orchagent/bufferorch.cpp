@@ -2,7 +2,10 @@
 
 #include "bufferorch.h"
 #include "logger.h"
+#include "saiserialize.h"
+#include "redispipeline.h"
 
+#include <chrono>
 #include <sstream>
 #include <iostream>
 
@@ -13,9 +16,76 @@ extern sai_buffer_api_t *sai_buffer_api;
 
 extern PortsOrch *gPortsOrch;
 extern sai_object_id_t gSwitchId;
+extern int gWatermarkInterval;
+extern bool gWatermarkClearOnRead;
 
 using namespace std;
 
+/* The current occupancy comes first, the watermarks after it are cleared in clear-on-read mode */
+static const vector<pair<sai_buffer_pool_stat_t, string>> poolWatermarkStatIds =
+{
+    { SAI_BUFFER_POOL_STAT_CURR_OCCUPANCY_BYTES,    "SAI_BUFFER_POOL_STAT_CURR_OCCUPANCY_BYTES" },
+    { SAI_BUFFER_POOL_STAT_WATERMARK_BYTES,         "SAI_BUFFER_POOL_STAT_WATERMARK_BYTES" },
+};
+
+static const vector<pair<sai_queue_stat_t, string>> queueWatermarkStatIds =
+{
+    { SAI_QUEUE_STAT_CURR_OCCUPANCY_BYTES,          "SAI_QUEUE_STAT_CURR_OCCUPANCY_BYTES" },
+    { SAI_QUEUE_STAT_WATERMARK_BYTES,               "SAI_QUEUE_STAT_WATERMARK_BYTES" },
+    { SAI_QUEUE_STAT_SHARED_WATERMARK_BYTES,        "SAI_QUEUE_STAT_SHARED_WATERMARK_BYTES" },
+};
+
+static const vector<pair<sai_ingress_priority_group_stat_t, string>> pgWatermarkStatIds =
+{
+    { SAI_INGRESS_PRIORITY_GROUP_STAT_CURR_OCCUPANCY_BYTES,     "SAI_INGRESS_PRIORITY_GROUP_STAT_CURR_OCCUPANCY_BYTES" },
+    { SAI_INGRESS_PRIORITY_GROUP_STAT_WATERMARK_BYTES,          "SAI_INGRESS_PRIORITY_GROUP_STAT_WATERMARK_BYTES" },
+    { SAI_INGRESS_PRIORITY_GROUP_STAT_SHARED_WATERMARK_BYTES,   "SAI_INGRESS_PRIORITY_GROUP_STAT_SHARED_WATERMARK_BYTES" },
+    { SAI_INGRESS_PRIORITY_GROUP_STAT_XOFF_ROOM_WATERMARK_BYTES,"SAI_INGRESS_PRIORITY_GROUP_STAT_XOFF_ROOM_WATERMARK_BYTES" },
+};
+
+/*
+ * Read all the watermark counters of every object with one stats call per
+ * object, and clear the watermarks afterwards in clear-on-read mode.
+ */
+template <typename stat_t, typename get_stats_t, typename clear_stats_t>
+static void readWatermarks(const set<sai_object_id_t> &ids,
+                           const vector<pair<stat_t, string>> &statIds,
+                           get_stats_t getStats, clear_stats_t clearStats,
+                           map<sai_object_id_t, vector<FieldValueTuple>> &values)
+{
+    vector<stat_t> counterIds;
+    for (const auto &it : statIds)
+    {
+        counterIds.push_back(it.first);
+    }
+    vector<uint64_t> counters(counterIds.size());
+
+    for (auto id : ids)
+    {
+        sai_status_t status = getStats(id, (uint32_t)counterIds.size(), counterIds.data(), counters.data());
+        if (status != SAI_STATUS_SUCCESS)
+        {
+            SWSS_LOG_DEBUG("Failed to get watermarks of 0x%lx, rv:%d", id, status);
+            continue;
+        }
+
+        if (gWatermarkClearOnRead)
+        {
+            status = clearStats(id, (uint32_t)counterIds.size() - 1, counterIds.data() + 1);
+            if (status != SAI_STATUS_SUCCESS)
+            {
+                SWSS_LOG_DEBUG("Failed to clear watermarks of 0x%lx, rv:%d", id, status);
+            }
+        }
+
+        auto &fieldValues = values[id];
+        for (size_t i = 0; i < counterIds.size(); i++)
+        {
+            fieldValues.emplace_back(statIds[i].second, to_string(counters[i]));
+        }
+    }
+}
+
 type_map BufferOrch::m_buffer_type_maps = {
     {APP_BUFFER_POOL_TABLE_NAME, new object_map()},
     {APP_BUFFER_PROFILE_TABLE_NAME, new object_map()},
@@ -29,8 +99,31 @@ BufferOrch::BufferOrch(DBConnector *db, vector<string> &tableNames) : Orch(db, t
 {
     SWSS_LOG_ENTER();
     initTableHandlers();
+
+    m_countersDb = unique_ptr<DBConnector>(new DBConnector(COUNTERS_DB, DBConnector::DEFAULT_UNIXSOCKET, 0));
+    m_poolNameMapTable = unique_ptr<Table>(new Table(m_countersDb.get(), COUNTERS_BUFFER_POOL_NAME_MAP));
+
+    if (gWatermarkInterval > 0)
+    {
+        m_collectWatermarks = true;
+        m_watermarkThread = thread(&BufferOrch::collectWatermarksThread, this);
+    }
 };
 
+BufferOrch::~BufferOrch()
+{
+    {
+        unique_lock<mutex> lock(m_watermarkMutex);
+        m_collectWatermarks = false;
+    }
+    m_sleepGuard.notify_all();
+
+    if (m_watermarkThread.joinable())
+    {
+        m_watermarkThread.join();
+    }
+}
+
 void BufferOrch::initTableHandlers()
 {
     SWSS_LOG_ENTER();
@@ -42,13 +135,11 @@ void BufferOrch::initTableHandlers()
     m_bufferHandlerMap.insert(buffer_handler_pair(APP_BUFFER_PORT_EGRESS_PROFILE_LIST_NAME, &BufferOrch::processEgressBufferProfileList));
 }
 
-task_process_status BufferOrch::processBufferPool(Consumer &consumer)
+task_process_status BufferOrch::processBufferPool(Consumer &consumer, KeyOpFieldsValuesTuple &tuple)
 {
     SWSS_LOG_ENTER();
     sai_status_t sai_status;
     sai_object_id_t sai_object = SAI_NULL_OBJECT_ID;
-    auto it = consumer.m_toSync.begin();
-    KeyOpFieldsValuesTuple tuple = it->second;
     string map_type_name = consumer.m_consumer->getTableName();
     string object_name = kfvKey(tuple);
     string op = kfvOp(tuple);
@@ -125,7 +216,8 @@ task_process_status BufferOrch::processBufferPool(Consumer &consumer)
                 SWSS_LOG_ERROR("Failed to modify buffer pool, name:%s, sai object:%lx, status:%d", object_name.c_str(), sai_object, sai_status);
                 return task_process_status::task_failed;
             }
-            SWSS_LOG_DEBUG("Modified existing pool:%lx, type:%s name:%s ", sai_object, map_type_name.c_str(), object_name.c_str());
+            SWSS_LOG_DEBUG("Modified existing pool:%lx, type:%s name:%s, referrers:%zd", sai_object, map_type_name.c_str(), object_name.c_str(),
+                           getObjectReferrers(getObjectKey(map_type_name, object_name)).size());
         }
         else
         {
@@ -137,17 +229,36 @@ task_process_status BufferOrch::processBufferPool(Consumer &consumer)
             }
             (*(m_buffer_type_maps[map_type_name]))[object_name] = sai_object;
             SWSS_LOG_NOTICE("Created buffer pool %s with type %s", object_name.c_str(), map_type_name.c_str());
+
+            vector<FieldValueTuple> fieldValues;
+            fieldValues.emplace_back(object_name, sai_serialize_object_id(sai_object));
+            m_poolNameMapTable->set("", fieldValues);
+
+            unique_lock<mutex> lock(m_watermarkMutex);
+            m_poolWatermarkIds.insert(sai_object);
         }
     }
     else if (op == DEL_COMMAND)
     {
+        if (isObjectReferenced(getObjectKey(map_type_name, object_name)))
+        {
+            SWSS_LOG_INFO("Buffer pool %s is still referenced, deferring removal", object_name.c_str());
+            return task_process_status::task_need_retry;
+        }
+        /* The pool must not be polled anymore once it is removed */
+        stopWatermarks(m_poolWatermarkIds, { sai_object });
         sai_status = sai_buffer_api->remove_buffer_pool(sai_object);
         if (SAI_STATUS_SUCCESS != sai_status)
         {
             SWSS_LOG_ERROR("Failed to remove buffer pool %s with type %s, rv:%d", object_name.c_str(), map_type_name.c_str(), sai_status);
+            unique_lock<mutex> lock(m_watermarkMutex);
+            m_poolWatermarkIds.insert(sai_object);
             return task_process_status::task_failed;
         }
         SWSS_LOG_NOTICE("Removed buffer pool %s with type %s", object_name.c_str(), map_type_name.c_str());
+        m_poolNameMapTable->hdel("", object_name);
+        Table countersTable(m_countersDb.get(), COUNTERS_TABLE);
+        countersTable.del(sai_serialize_object_id(sai_object));
         auto it_to_delete = (m_buffer_type_maps[map_type_name])->find(object_name);
         (m_buffer_type_maps[map_type_name])->erase(it_to_delete);
     }
@@ -159,13 +270,11 @@ task_process_status BufferOrch::processBufferPool(Consumer &consumer)
     return task_process_status::task_success;
 }
 
-task_process_status BufferOrch::processBufferProfile(Consumer &consumer)
+task_process_status BufferOrch::processBufferProfile(Consumer &consumer, KeyOpFieldsValuesTuple &tuple)
 {
     SWSS_LOG_ENTER();
     sai_status_t sai_status;
     sai_object_id_t sai_object = SAI_NULL_OBJECT_ID;
-    auto it = consumer.m_toSync.begin();
-    KeyOpFieldsValuesTuple tuple = it->second;
     string map_type_name = consumer.m_consumer->getTableName();
     string object_name = kfvKey(tuple);
     string op = kfvOp(tuple);
@@ -180,6 +289,7 @@ task_process_status BufferOrch::processBufferProfile(Consumer &consumer)
     if (op == SET_COMMAND)
     {
         vector<sai_attribute_t> attribs;
+        set<string> references;
         for (auto i = kfvFieldsValues(tuple).begin(); i != kfvFieldsValues(tuple).end(); i++)
         {
             SWSS_LOG_DEBUG("field:%s, value:%s", fvField(*i).c_str(), fvValue(*i).c_str());
@@ -187,7 +297,7 @@ task_process_status BufferOrch::processBufferProfile(Consumer &consumer)
             if (fvField(*i) == buffer_pool_field_name)
             {
                 sai_object_id_t sai_pool;
-                ref_resolve_status resolve_result = resolveFieldRefValue(m_buffer_type_maps, buffer_pool_field_name, tuple, sai_pool);
+                ref_resolve_status resolve_result = resolveFieldRefValue(m_buffer_type_maps, buffer_pool_field_name, tuple, sai_pool, &references);
                 if (ref_resolve_status::success != resolve_result)
                 {
                     if(ref_resolve_status::not_resolved == resolve_result)
@@ -248,7 +358,8 @@ task_process_status BufferOrch::processBufferProfile(Consumer &consumer)
         }
         if (SAI_NULL_OBJECT_ID != sai_object)
         {
-            SWSS_LOG_DEBUG("Modifying existing sai object:%lx ", sai_object);
+            SWSS_LOG_DEBUG("Modifying existing sai object:%lx, referrers:%zd", sai_object,
+                           getObjectReferrers(getObjectKey(map_type_name, object_name)).size());
             sai_status = sai_buffer_api->set_buffer_profile_attribute(sai_object, &attribs[0]);
             if (SAI_STATUS_SUCCESS != sai_status)
             {
@@ -267,9 +378,15 @@ task_process_status BufferOrch::processBufferProfile(Consumer &consumer)
             (*(m_buffer_type_maps[map_type_name]))[object_name] = sai_object;
             SWSS_LOG_NOTICE("Created buffer profile %s with type %s", object_name.c_str(), map_type_name.c_str());
         }
+        setObjectReferences(getObjectKey(map_type_name, object_name), references);
     }
     else if (op == DEL_COMMAND)
     {
+        if (isObjectReferenced(getObjectKey(map_type_name, object_name)))
+        {
+            SWSS_LOG_INFO("Buffer profile %s is still referenced, deferring removal", object_name.c_str());
+            return task_process_status::task_need_retry;
+        }
         sai_status = sai_buffer_api->remove_buffer_profile(sai_object);
         if (SAI_STATUS_SUCCESS != sai_status)
         {
@@ -277,6 +394,7 @@ task_process_status BufferOrch::processBufferProfile(Consumer &consumer)
             return task_process_status::task_failed;
         }
         SWSS_LOG_NOTICE("Remove buffer profile %s with type %s", object_name.c_str(), map_type_name.c_str());
+        removeObjectReferences(getObjectKey(map_type_name, object_name));
         auto it_to_delete = (m_buffer_type_maps[map_type_name])->find(object_name);
         (m_buffer_type_maps[map_type_name])->erase(it_to_delete);
     }
@@ -289,157 +407,330 @@ task_process_status BufferOrch::processBufferProfile(Consumer &consumer)
 }
 
 /*
-Input sample "BUFFER_QUEUE_TABLE:Ethernet4,Ethernet45:10-15"
+Expands a queue or PG key such as "Ethernet4,Ethernet45:10-15" into the SAI
+objects it covers. The expansion is cached per key, so retries and changes of
+the profile do not parse the key or look up the ports again.
 */
-task_process_status BufferOrch::processQueue(Consumer &consumer)
+const BufferOrch::range_key *BufferOrch::compileRangeKey(const string &table_name, const string &key)
 {
     SWSS_LOG_ENTER();
-    auto it = consumer.m_toSync.begin();
-    KeyOpFieldsValuesTuple tuple = it->second;
-    sai_object_id_t sai_buffer_profile;
-    string key = kfvKey(tuple);
-    string op = kfvOp(tuple);
-    vector<string> tokens;
-    sai_uint32_t range_low, range_high;
 
-    SWSS_LOG_DEBUG("Processing:%s", key.c_str());
-    tokens = tokenize(key, delimiter);
+    auto &compiled_keys = m_rangeKeys[table_name];
+    auto compiled = compiled_keys.find(key);
+    if (compiled != compiled_keys.end())
+    {
+        return &compiled->second;
+    }
+
+    vector<string> tokens = tokenize(key, delimiter);
     if (tokens.size() != 2)
     {
         SWSS_LOG_ERROR("malformed key:%s. Must contain 2 tokens", key.c_str());
-        return task_process_status::task_invalid_entry;
+        return NULL;
     }
     vector<string> port_names = tokenize(tokens[0], list_item_delimiter);
+    sai_uint32_t range_low, range_high;
     if (!parseIndexRange(tokens[1], range_low, range_high))
     {
-        return task_process_status::task_invalid_entry;
+        SWSS_LOG_ERROR("Failed to obtain range values of key:%s", key.c_str());
+        return NULL;
     }
-    ref_resolve_status  resolve_result = resolveFieldRefValue(m_buffer_type_maps, buffer_profile_field_name, tuple, sai_buffer_profile);
-    if (ref_resolve_status::success != resolve_result)
-    {
-        if(ref_resolve_status::not_resolved == resolve_result)
-        {
-            SWSS_LOG_INFO("Missing or invalid queue buffer profile reference specified");
-            return task_process_status::task_need_retry;
-        }
-        SWSS_LOG_ERROR("Resolving queue profile reference failed");
-        return task_process_status::task_failed;
-    }
-    sai_attribute_t attr;
-    attr.id = SAI_QUEUE_ATTR_BUFFER_PROFILE_ID;
-    attr.value.oid = sai_buffer_profile;
+
+    range_key items;
     for (string port_name : port_names)
     {
-        Port port;
         SWSS_LOG_DEBUG("processing port:%s", port_name.c_str());
-        if (!gPortsOrch->getPort(port_name, port))
+        Port *port = gPortsOrch->findPort(port_name);
+        if (!port)
         {
             SWSS_LOG_ERROR("Port with alias:%s not found", port_name.c_str());
-            return task_process_status::task_invalid_entry;
+            return NULL;
         }
+        const vector<sai_object_id_t> &object_ids = (table_name == APP_BUFFER_QUEUE_TABLE_NAME) ?
+            port->m_queue_ids : port->m_priority_group_ids;
         for (size_t ind = range_low; ind <= range_high; ind++)
         {
-            sai_object_id_t queue_id;
-            SWSS_LOG_DEBUG("processing queue:%zd", ind);
-            if (port.m_queue_ids.size() <= ind)
+            if (object_ids.size() <= ind)
             {
-                SWSS_LOG_ERROR("Invalid queue index specified:%zd", ind);
-                return task_process_status::task_invalid_entry;
+                SWSS_LOG_ERROR("Invalid index specified:%zd, port:%s", ind, port_name.c_str());
+                return NULL;
             }
-            queue_id = port.m_queue_ids[ind];
-            SWSS_LOG_DEBUG("Applying buffer profile:0x%lx to queue index:%zd, queue sai_id:0x%lx", sai_buffer_profile, ind, queue_id);
-            sai_status_t sai_status = sai_queue_api->set_queue_attribute(queue_id, &attr);
-            if (sai_status != SAI_STATUS_SUCCESS)
+            items.push_back({ port_name, ind, object_ids[ind] });
+        }
+    }
+
+    return &(compiled_keys[key] = move(items));
+}
+
+/*
+Input sample "BUFFER_QUEUE_TABLE:Ethernet4,Ethernet45:10-15"
+*/
+task_process_status BufferOrch::processQueue(Consumer &consumer, KeyOpFieldsValuesTuple &tuple)
+{
+    SWSS_LOG_ENTER();
+    sai_object_id_t sai_buffer_profile;
+    string key = kfvKey(tuple);
+    string op = kfvOp(tuple);
+    string table_name = consumer.m_consumer->getTableName();
+
+    SWSS_LOG_DEBUG("Processing:%s", key.c_str());
+    const range_key *items = compileRangeKey(table_name, key);
+    if (!items)
+    {
+        return task_process_status::task_invalid_entry;
+    }
+    set<string> references;
+    if (op == DEL_COMMAND)
+    {
+        /* Unbind the profile so that it can be removed */
+        sai_buffer_profile = SAI_NULL_OBJECT_ID;
+    }
+    else
+    {
+        ref_resolve_status  resolve_result = resolveFieldRefValue(m_buffer_type_maps, buffer_profile_field_name, tuple, sai_buffer_profile, &references);
+        if (ref_resolve_status::success != resolve_result)
+        {
+            if(ref_resolve_status::not_resolved == resolve_result)
             {
-                SWSS_LOG_ERROR("Failed to set queue's buffer profile attribute, status:%d", sai_status);
-                return task_process_status::task_failed;
+                SWSS_LOG_INFO("Missing or invalid queue buffer profile reference specified");
+                return task_process_status::task_need_retry;
             }
+            SWSS_LOG_ERROR("Resolving queue profile reference failed");
+            return task_process_status::task_failed;
         }
     }
+    sai_attribute_t attr;
+    attr.id = SAI_QUEUE_ATTR_BUFFER_PROFILE_ID;
+    attr.value.oid = sai_buffer_profile;
+    for (const auto &item : *items)
+    {
+        SWSS_LOG_DEBUG("Applying buffer profile:0x%lx to port:%s queue index:%zd, queue sai_id:0x%lx",
+                       sai_buffer_profile, item.port_name.c_str(), item.index, item.object_id);
+        sai_status_t sai_status = sai_queue_api->set_queue_attribute(item.object_id, &attr);
+        if (sai_status != SAI_STATUS_SUCCESS)
+        {
+            SWSS_LOG_ERROR("Failed to set queue's buffer profile attribute, status:%d", sai_status);
+            return task_process_status::task_failed;
+        }
+    }
+    if (op == DEL_COMMAND)
+    {
+        removeWatermarks(table_name, *items);
+        m_rangeKeys[table_name].erase(key);
+    }
+    else
+    {
+        addWatermarks(table_name, *items);
+    }
+    setObjectReferences(getObjectKey(table_name, key), references);
     return task_process_status::task_success;
 }
 
 /*
 Input sample "BUFFER_PG_TABLE:Ethernet4,Ethernet45:10-15"
 */
-task_process_status BufferOrch::processPriorityGroup(Consumer &consumer)
+task_process_status BufferOrch::processPriorityGroup(Consumer &consumer, KeyOpFieldsValuesTuple &tuple)
 {
     SWSS_LOG_ENTER();
-    auto it = consumer.m_toSync.begin();
-    KeyOpFieldsValuesTuple tuple = it->second;
     sai_object_id_t sai_buffer_profile;
     string key = kfvKey(tuple);
     string op = kfvOp(tuple);
-    vector<string> tokens;
-    sai_uint32_t range_low, range_high;
+    string table_name = consumer.m_consumer->getTableName();
 
     SWSS_LOG_DEBUG("processing:%s", key.c_str());
-    tokens = tokenize(key, delimiter);
-    if (tokens.size() != 2)
+    const range_key *items = compileRangeKey(table_name, key);
+    if (!items)
     {
-        SWSS_LOG_ERROR("malformed key:%s. Must contain 2 tokens", key.c_str());
         return task_process_status::task_invalid_entry;
     }
-    vector<string> port_names = tokenize(tokens[0], list_item_delimiter);
-    if (!parseIndexRange(tokens[1], range_low, range_high))
+    set<string> references;
+    if (op == DEL_COMMAND)
     {
-        SWSS_LOG_ERROR("Failed to obtain pg range values");
-        return task_process_status::task_invalid_entry;
+        /* Unbind the profile so that it can be removed */
+        sai_buffer_profile = SAI_NULL_OBJECT_ID;
     }
-    ref_resolve_status  resolve_result = resolveFieldRefValue(m_buffer_type_maps, buffer_profile_field_name, tuple, sai_buffer_profile);
-    if (ref_resolve_status::success != resolve_result)
+    else
     {
-        if(ref_resolve_status::not_resolved == resolve_result)
+        ref_resolve_status  resolve_result = resolveFieldRefValue(m_buffer_type_maps, buffer_profile_field_name, tuple, sai_buffer_profile, &references);
+        if (ref_resolve_status::success != resolve_result)
         {
-            SWSS_LOG_INFO("Missing or invalid pg profile reference specified");
-            return task_process_status::task_need_retry;
+            if(ref_resolve_status::not_resolved == resolve_result)
+            {
+                SWSS_LOG_INFO("Missing or invalid pg profile reference specified");
+                return task_process_status::task_need_retry;
+            }
+            SWSS_LOG_ERROR("Resolving pg profile reference failed");
+            return task_process_status::task_failed;
         }
-        SWSS_LOG_ERROR("Resolving pg profile reference failed");
-        return task_process_status::task_failed;
     }
     sai_attribute_t attr;
     attr.id = SAI_INGRESS_PRIORITY_GROUP_ATTR_BUFFER_PROFILE;
     attr.value.oid = sai_buffer_profile;
-    for (string port_name : port_names)
+    for (const auto &item : *items)
     {
-        Port port;
-        SWSS_LOG_DEBUG("processing port:%s", port_name.c_str());
-        if (!gPortsOrch->getPort(port_name, port))
+        SWSS_LOG_DEBUG("Applying buffer profile:0x%lx to port:%s pg index:%zd, pg sai_id:0x%lx",
+                       sai_buffer_profile, item.port_name.c_str(), item.index, item.object_id);
+        sai_status_t sai_status = sai_buffer_api->set_ingress_priority_group_attribute(item.object_id, &attr);
+        if (sai_status != SAI_STATUS_SUCCESS)
         {
-            SWSS_LOG_ERROR("Port with alias:%s not found", port_name.c_str());
-            return task_process_status::task_invalid_entry;
+            SWSS_LOG_ERROR("Failed to set port:%s pg:%zd buffer profile attribute, status:%d", item.port_name.c_str(), item.index, sai_status);
+            return task_process_status::task_failed;
         }
-        for (size_t ind = range_low; ind <= range_high; ind++)
+    }
+    if (op == DEL_COMMAND)
+    {
+        removeWatermarks(table_name, *items);
+        m_rangeKeys[table_name].erase(key);
+    }
+    else
+    {
+        addWatermarks(table_name, *items);
+    }
+    setObjectReferences(getObjectKey(table_name, key), references);
+    return task_process_status::task_success;
+}
+
+void BufferOrch::addWatermarks(const string &table_name, const range_key &items)
+{
+    unique_lock<mutex> lock(m_watermarkMutex);
+    auto &ids = (table_name == APP_BUFFER_QUEUE_TABLE_NAME) ? m_queueWatermarkIds : m_pgWatermarkIds;
+    for (const auto &item : items)
+    {
+        ids.insert(item.object_id);
+    }
+}
+
+void BufferOrch::removeWatermarks(const string &table_name, const range_key &items)
+{
+    vector<sai_object_id_t> ids;
+    for (const auto &item : items)
+    {
+        ids.push_back(item.object_id);
+    }
+    stopWatermarks((table_name == APP_BUFFER_QUEUE_TABLE_NAME) ? m_queueWatermarkIds : m_pgWatermarkIds, ids);
+
+    /* Queue and PG keys are shared with other counters, remove only the watermark fields */
+    vector<string> fields;
+    if (table_name == APP_BUFFER_QUEUE_TABLE_NAME)
+    {
+        for (const auto &it : queueWatermarkStatIds)
+        {
+            fields.push_back(it.second);
+        }
+    }
+    else
+    {
+        for (const auto &it : pgWatermarkStatIds)
+        {
+            fields.push_back(it.second);
+        }
+    }
+
+    Table countersTable(m_countersDb.get(), COUNTERS_TABLE);
+    for (const auto &item : items)
+    {
+        for (const auto &field : fields)
         {
-            sai_object_id_t pg_id;
-            SWSS_LOG_DEBUG("processing pg:%zd", ind);
-            if (port.m_priority_group_ids.size() <= ind)
+            countersTable.hdel(sai_serialize_object_id(item.object_id), field);
+        }
+    }
+}
+
+/*
+ * Stop polling the objects and wait until the watermark thread no longer
+ * reads them, so that they can be removed from SAI and COUNTERS_DB.
+ */
+void BufferOrch::stopWatermarks(set<sai_object_id_t> &watermarkIds, const vector<sai_object_id_t> &ids)
+{
+    unique_lock<mutex> lock(m_watermarkMutex);
+
+    for (auto id : ids)
+    {
+        watermarkIds.erase(id);
+    }
+
+    m_watermarksDone.wait(lock, [&] {
+        for (auto id : ids)
+        {
+            if (m_watermarksInFlight.count(id))
             {
-                SWSS_LOG_ERROR("Invalid pg index specified:%zd", ind);
-                return task_process_status::task_invalid_entry;
+                return false;
             }
-            pg_id = port.m_priority_group_ids[ind];
-            SWSS_LOG_DEBUG("Applying buffer profile:0x%lx to port:%s pg index:%zd, pg sai_id:0x%lx", sai_buffer_profile, port_name.c_str(), ind, pg_id);
-            sai_status_t sai_status = sai_buffer_api->set_ingress_priority_group_attribute(pg_id, &attr);
-            if (sai_status != SAI_STATUS_SUCCESS)
+        }
+        return true;
+    });
+}
+
+/*
+ * Poll the watermarks of the buffer pools and of the bound queues and PGs
+ * every gWatermarkInterval milliseconds. The objects are polled from a copy
+ * of the id sets, so the main thread is not blocked by the SAI calls, and all
+ * of them are written to COUNTERS_DB through one pipeline flush per interval.
+ */
+void BufferOrch::collectWatermarksThread()
+{
+    SWSS_LOG_ENTER();
+
+    DBConnector db(COUNTERS_DB, DBConnector::DEFAULT_UNIXSOCKET, 0);
+    RedisPipeline pipeline(&db);
+    Table countersTable(&pipeline, COUNTERS_TABLE, true);
+
+    unique_lock<mutex> lock(m_watermarkMutex);
+
+    while (m_collectWatermarks)
+    {
+        auto updStart = chrono::steady_clock::now();
+
+        set<sai_object_id_t> poolIds = m_poolWatermarkIds;
+        set<sai_object_id_t> queueIds = m_queueWatermarkIds;
+        set<sai_object_id_t> pgIds = m_pgWatermarkIds;
+        m_watermarksInFlight.insert(poolIds.begin(), poolIds.end());
+        m_watermarksInFlight.insert(queueIds.begin(), queueIds.end());
+        m_watermarksInFlight.insert(pgIds.begin(), pgIds.end());
+        lock.unlock();
+
+        map<sai_object_id_t, vector<FieldValueTuple>> values;
+        readWatermarks(poolIds, poolWatermarkStatIds,
+                       sai_buffer_api->get_buffer_pool_stats, sai_buffer_api->clear_buffer_pool_stats, values);
+        readWatermarks(queueIds, queueWatermarkStatIds,
+                       sai_queue_api->get_queue_stats, sai_queue_api->clear_queue_stats, values);
+        readWatermarks(pgIds, pgWatermarkStatIds,
+                       sai_buffer_api->get_ingress_priority_group_stats, sai_buffer_api->clear_ingress_priority_group_stats, values);
+
+        lock.lock();
+
+        /* Skip the objects removed while they were polled */
+        for (const auto &it : values)
+        {
+            if (m_poolWatermarkIds.count(it.first) || m_queueWatermarkIds.count(it.first) || m_pgWatermarkIds.count(it.first))
             {
-                SWSS_LOG_ERROR("Failed to set port:%s pg:%zd buffer profile attribute, status:%d", port_name.c_str(), ind, sai_status);
-                return task_process_status::task_failed;
+                countersTable.set(sai_serialize_object_id(it.first), it.second);
             }
         }
+        pipeline.flush();
+
+        m_watermarksInFlight.clear();
+        m_watermarksDone.notify_all();
+
+        chrono::duration<double, milli> timeToSleep =
+            chrono::milliseconds(gWatermarkInterval) - (chrono::steady_clock::now() - updStart);
+        if (timeToSleep > chrono::milliseconds(0))
+        {
+            m_sleepGuard.wait_for(lock, timeToSleep);
+        }
+        else
+        {
+            SWSS_LOG_WARN("Buffer watermark update time is greater than the configured update period");
+        }
     }
-    return task_process_status::task_success;
 }
 
 /*
 Input sample:"[BUFFER_PROFILE_TABLE:i_port.profile0],[BUFFER_PROFILE_TABLE:i_port.profile1]"
 */
-task_process_status BufferOrch::processIngressBufferProfileList(Consumer &consumer)
+task_process_status BufferOrch::processIngressBufferProfileList(Consumer &consumer, KeyOpFieldsValuesTuple &tuple)
 {
     SWSS_LOG_ENTER();
-    auto it = consumer.m_toSync.begin();
-    KeyOpFieldsValuesTuple tuple = it->second;
-    Port port;
     string key = kfvKey(tuple);
     string op = kfvOp(tuple);
 
@@ -451,16 +742,21 @@ task_process_status BufferOrch::processIngressBufferProfileList(Consumer &consum
     }
     vector<string> port_names = tokenize(key, list_item_delimiter);
     vector<sai_object_id_t> profile_list;
-    ref_resolve_status resolve_status = resolveFieldRefArray(m_buffer_type_maps, buffer_profile_list_field_name, tuple, profile_list);
-    if (ref_resolve_status::success != resolve_status)
+    set<string> references;
+    /* DEL unbinds the profile list so that the profiles can be removed */
+    if (op != DEL_COMMAND)
     {
-        if(ref_resolve_status::not_resolved == resolve_status)
+        ref_resolve_status resolve_status = resolveFieldRefArray(m_buffer_type_maps, buffer_profile_list_field_name, tuple, profile_list, &references);
+        if (ref_resolve_status::success != resolve_status)
         {
-            SWSS_LOG_INFO("Missing or invalid ingress buffer profile reference specified for:%s", key.c_str());
-            return task_process_status::task_need_retry;
+            if(ref_resolve_status::not_resolved == resolve_status)
+            {
+                SWSS_LOG_INFO("Missing or invalid ingress buffer profile reference specified for:%s", key.c_str());
+                return task_process_status::task_need_retry;
+            }
+            SWSS_LOG_ERROR("Failed resolving ingress buffer profile reference specified for:%s", key.c_str());
+            return task_process_status::task_failed;
         }
-        SWSS_LOG_ERROR("Failed resolving ingress buffer profile reference specified for:%s", key.c_str());
-        return task_process_status::task_failed;
     }
     sai_attribute_t attr;
     attr.id = SAI_PORT_ATTR_QOS_INGRESS_BUFFER_PROFILE_LIST;
@@ -468,45 +764,49 @@ task_process_status BufferOrch::processIngressBufferProfileList(Consumer &consum
     attr.value.objlist.list = profile_list.data();
     for (string port_name : port_names)
     {
-        if (!gPortsOrch->getPort(port_name, port))
+        Port *port = gPortsOrch->findPort(port_name);
+        if (!port)
         {
             SWSS_LOG_ERROR("Port with alias:%s not found", port_name.c_str());
             return task_process_status::task_invalid_entry;
         }
-        sai_status_t sai_status = sai_port_api->set_port_attribute(port.m_port_id, &attr);
+        sai_status_t sai_status = sai_port_api->set_port_attribute(port->m_port_id, &attr);
         if (sai_status != SAI_STATUS_SUCCESS)
         {
             SWSS_LOG_ERROR("Failed to set ingress buffer profile list on port, status:%d, key:%s", sai_status, port_name.c_str());
             return task_process_status::task_failed;
         }
     }
+    setObjectReferences(getObjectKey(consumer.m_consumer->getTableName(), key), references);
     return task_process_status::task_success;
 }
 
 /*
 Input sample:"[BUFFER_PROFILE_TABLE:e_port.profile0],[BUFFER_PROFILE_TABLE:e_port.profile1]"
 */
-task_process_status BufferOrch::processEgressBufferProfileList(Consumer &consumer)
+task_process_status BufferOrch::processEgressBufferProfileList(Consumer &consumer, KeyOpFieldsValuesTuple &tuple)
 {
     SWSS_LOG_ENTER();
-    auto it = consumer.m_toSync.begin();
-    KeyOpFieldsValuesTuple tuple = it->second;
-    Port port;
     string key = kfvKey(tuple);
     string op = kfvOp(tuple);
     SWSS_LOG_DEBUG("processing:%s", key.c_str());
     vector<string> port_names = tokenize(key, list_item_delimiter);
     vector<sai_object_id_t> profile_list;
-    ref_resolve_status resolve_status = resolveFieldRefArray(m_buffer_type_maps, buffer_profile_list_field_name, tuple, profile_list);
-    if (ref_resolve_status::success != resolve_status)
+    set<string> references;
+    /* DEL unbinds the profile list so that the profiles can be removed */
+    if (op != DEL_COMMAND)
     {
-        if(ref_resolve_status::not_resolved == resolve_status)
+        ref_resolve_status resolve_status = resolveFieldRefArray(m_buffer_type_maps, buffer_profile_list_field_name, tuple, profile_list, &references);
+        if (ref_resolve_status::success != resolve_status)
         {
-            SWSS_LOG_INFO("Missing or invalid egress buffer profile reference specified for:%s", key.c_str());
-            return task_process_status::task_need_retry;
+            if(ref_resolve_status::not_resolved == resolve_status)
+            {
+                SWSS_LOG_INFO("Missing or invalid egress buffer profile reference specified for:%s", key.c_str());
+                return task_process_status::task_need_retry;
+            }
+            SWSS_LOG_ERROR("Failed resolving egress buffer profile reference specified for:%s", key.c_str());
+            return task_process_status::task_failed;
         }
-        SWSS_LOG_ERROR("Failed resolving egress buffer profile reference specified for:%s", key.c_str());
-        return task_process_status::task_failed;
     }
     sai_attribute_t attr;
     attr.id = SAI_PORT_ATTR_QOS_EGRESS_BUFFER_PROFILE_LIST;
@@ -514,58 +814,91 @@ task_process_status BufferOrch::processEgressBufferProfileList(Consumer &consume
     attr.value.objlist.list = profile_list.data();
     for (string port_name : port_names)
     {
-        if (!gPortsOrch->getPort(port_name, port))
+        Port *port = gPortsOrch->findPort(port_name);
+        if (!port)
         {
             SWSS_LOG_ERROR("Port with alias:%s not found", port_name.c_str());
             return task_process_status::task_invalid_entry;
         }
-        sai_status_t sai_status = sai_port_api->set_port_attribute(port.m_port_id, &attr);
+        sai_status_t sai_status = sai_port_api->set_port_attribute(port->m_port_id, &attr);
         if (sai_status != SAI_STATUS_SUCCESS)
         {
             SWSS_LOG_ERROR("Failed to set egress buffer profile list on port, status:%d, key:%s", sai_status, port_name.c_str());
             return task_process_status::task_failed;
         }
     }
+    setObjectReferences(getObjectKey(consumer.m_consumer->getTableName(), key), references);
     return task_process_status::task_success;
 }
 
+void BufferOrch::doTask()
+{
+    /* Process the tables in dependency order: pools before the profiles using them, profiles before the queues, PGs and ports */
+    static const vector<string> tableOrder = {
+        APP_BUFFER_POOL_TABLE_NAME,
+        APP_BUFFER_PROFILE_TABLE_NAME,
+        APP_BUFFER_QUEUE_TABLE_NAME,
+        APP_BUFFER_PG_TABLE_NAME,
+        APP_BUFFER_PORT_INGRESS_PROFILE_LIST_NAME,
+        APP_BUFFER_PORT_EGRESS_PROFILE_LIST_NAME
+    };
+
+    Orch::doTask(tableOrder);
+}
+
 void BufferOrch::doTask(Consumer &consumer)
 {
     SWSS_LOG_ENTER();
+
+    /* Make sure the handler is initialized for the task */
+    auto map_type_name = consumer.m_consumer->getTableName();
+    auto handler_it = m_bufferHandlerMap.find(map_type_name);
+    if (handler_it == m_bufferHandlerMap.end())
+    {
+        SWSS_LOG_ERROR("No handler for key:%s found.", map_type_name.c_str());
+        consumer.m_toSync.clear();
+        return;
+    }
+    auto handler = handler_it->second;
+
+    /* Process the whole batch with the same handler, the status is kept per item */
+    size_t retried = 0;
+    size_t failed = 0;
     auto it = consumer.m_toSync.begin();
     while (it != consumer.m_toSync.end())
     {
-        /* Make sure the handler is initialized for the task */
-        auto map_type_name = consumer.m_consumer->getTableName();
-        if (m_bufferHandlerMap.find(map_type_name) == m_bufferHandlerMap.end())
-        {
-            SWSS_LOG_ERROR("No handler for key:%s found.", map_type_name.c_str());
-            it = consumer.m_toSync.erase(it);
-            continue;
-        }
-
-        auto task_status = (this->*(m_bufferHandlerMap[map_type_name]))(consumer);
+        auto task_status = (this->*handler)(consumer, it->second);
         switch(task_status)
         {
             case task_process_status::task_success :
                 it = consumer.m_toSync.erase(it);
                 break;
-            case task_process_status::task_invalid_entry:
-                SWSS_LOG_ERROR("Failed to process invalid buffer task");
+            case task_process_status::task_invalid_entry :
+                SWSS_LOG_ERROR("Failed to process invalid buffer task %s", it->first.c_str());
                 it = consumer.m_toSync.erase(it);
+                failed++;
                 break;
-            case task_process_status::task_failed:
-                SWSS_LOG_ERROR("Failed to process buffer task, drop it");
+            case task_process_status::task_failed :
+                SWSS_LOG_ERROR("Failed to process buffer task %s, drop it", it->first.c_str());
                 it = consumer.m_toSync.erase(it);
-                return;
-            case task_process_status::task_need_retry:
-                SWSS_LOG_INFO("Failed to process buffer task, retry it");
+                failed++;
+                break;
+            case task_process_status::task_need_retry :
+                SWSS_LOG_INFO("Failed to process buffer task %s, retry it", it->first.c_str());
                 it++;
+                retried++;
                 break;
             default:
                 SWSS_LOG_ERROR("Invalid task status %d", task_status);
                 it = consumer.m_toSync.erase(it);
+                failed++;
                 break;
         }
     }
+
+    if (retried || failed)
+    {
+        SWSS_LOG_INFO("Processed buffer table %s: %zd failed, %zd pending retry",
+                      map_type_name.c_str(), failed, retried);
+    }
 }
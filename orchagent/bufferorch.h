@@ -2,9 +2,15 @@
 #define SWSS_BUFFORCH_H
 
 #include <map>
+#include <set>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 #include "orch.h"
 #include "portsorch.h"
 
+#define COUNTERS_BUFFER_POOL_NAME_MAP   "COUNTERS_BUFFER_POOL_NAME_MAP"
+
 const string buffer_size_field_name         = "size";
 const string buffer_pool_type_field_name    = "type";
 const string buffer_pool_mode_field_name    = "mode";
@@ -24,22 +30,58 @@ class BufferOrch : public Orch
 {
 public:
     BufferOrch(DBConnector *db, vector<string> &tableNames);
+    ~BufferOrch();
     static type_map m_buffer_type_maps;
+
+    void doTask();
 private:
-    typedef task_process_status (BufferOrch::*buffer_table_handler)(Consumer& consumer);
+    typedef task_process_status (BufferOrch::*buffer_table_handler)(Consumer &consumer, KeyOpFieldsValuesTuple &tuple);
     typedef map<string, buffer_table_handler> buffer_table_handler_map;
     typedef pair<string, buffer_table_handler> buffer_handler_pair;
 
+    /* Queue or PG of a port covered by a BUFFER_QUEUE/BUFFER_PG key */
+    struct range_key_item
+    {
+        string port_name;
+        size_t index;
+        sai_object_id_t object_id;
+    };
+    typedef vector<range_key_item> range_key;
+
     virtual void doTask(Consumer& consumer);
     void initTableHandlers();
-    task_process_status processBufferPool(Consumer &consumer);
-    task_process_status processBufferProfile(Consumer &consumer);
-    task_process_status processQueue(Consumer &consumer);
-    task_process_status processPriorityGroup(Consumer &consumer);
-    task_process_status processIngressBufferProfileList(Consumer &consumer);
-    task_process_status processEgressBufferProfileList(Consumer &consumer);
+    task_process_status processBufferPool(Consumer &consumer, KeyOpFieldsValuesTuple &tuple);
+    task_process_status processBufferProfile(Consumer &consumer, KeyOpFieldsValuesTuple &tuple);
+    const range_key *compileRangeKey(const string &table_name, const string &key);
+    task_process_status processQueue(Consumer &consumer, KeyOpFieldsValuesTuple &tuple);
+    task_process_status processPriorityGroup(Consumer &consumer, KeyOpFieldsValuesTuple &tuple);
+    task_process_status processIngressBufferProfileList(Consumer &consumer, KeyOpFieldsValuesTuple &tuple);
+    task_process_status processEgressBufferProfileList(Consumer &consumer, KeyOpFieldsValuesTuple &tuple);
+
+    void addWatermarks(const string &table_name, const range_key &items);
+    void removeWatermarks(const string &table_name, const range_key &items);
+    void stopWatermarks(set<sai_object_id_t> &watermarkIds, const vector<sai_object_id_t> &ids);
+    void collectWatermarksThread();
 
     buffer_table_handler_map m_bufferHandlerMap;
+    /* Compiled queue and PG keys, per table */
+    map<string, map<string, range_key>> m_rangeKeys;
+
+    /* Buffer pools, queues and PGs polled by the watermark thread */
+    set<sai_object_id_t> m_poolWatermarkIds;
+    set<sai_object_id_t> m_queueWatermarkIds;
+    set<sai_object_id_t> m_pgWatermarkIds;
+    unique_ptr<DBConnector> m_countersDb;
+    unique_ptr<Table> m_poolNameMapTable;
+
+    /* Objects read by the watermark thread in the current round */
+    set<sai_object_id_t> m_watermarksInFlight;
+
+    mutex m_watermarkMutex;
+    condition_variable m_sleepGuard;
+    condition_variable m_watermarksDone;
+    bool m_collectWatermarks = false;
+    thread m_watermarkThread;
 };
 #endif /* SWSS_BUFFORCH_H */
 
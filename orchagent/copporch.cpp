@@ -2,6 +2,8 @@
 #include "tokenize.h"
 #include "copporch.h"
 #include "logger.h"
+#include "saiserialize.h"
+#include "counterpollorch.h"
 
 #include <sstream>
 #include <iostream>
@@ -13,6 +15,7 @@ extern sai_hostif_api_t*    sai_hostif_api;
 extern sai_policer_api_t*   sai_policer_api;
 extern sai_switch_api_t*    sai_switch_api;
 extern sai_object_id_t      gSwitchId;
+extern CounterPollOrch      *gCounterPollOrch;
 
 #define MLNX_PLATFORM_SUBSTRING     "mlnx"
 
@@ -80,6 +83,105 @@ map<string, sai_packet_action_t> packet_action_map = {
     {"transit", SAI_PACKET_ACTION_TRANSIT}
 };
 
+bool parsePolicerAttribute(const string &field, const string &value, sai_attribute_t &attr)
+{
+    SWSS_LOG_ENTER();
+
+    if (field == copp_policer_meter_type_field)
+    {
+        attr.id = SAI_POLICER_ATTR_METER_TYPE;
+        attr.value.s32 = policer_meter_map.at(value);
+    }
+    else if (field == copp_policer_mode_field)
+    {
+        attr.id = SAI_POLICER_ATTR_MODE;
+        attr.value.s32 = policer_mode_map.at(value);
+    }
+    else if (field == copp_policer_color_field)
+    {
+        attr.id = SAI_POLICER_ATTR_COLOR_SOURCE;
+        attr.value.s32 = policer_color_aware_map.at(value);
+    }
+    else if (field == copp_policer_cbs_field)
+    {
+        attr.id = SAI_POLICER_ATTR_CBS;
+        attr.value.u64 = stoul(value);
+    }
+    else if (field == copp_policer_cir_field)
+    {
+        attr.id = SAI_POLICER_ATTR_CIR;
+        attr.value.u64 = stoul(value);
+    }
+    else if (field == copp_policer_pbs_field)
+    {
+        attr.id = SAI_POLICER_ATTR_PBS;
+        attr.value.u64 = stoul(value);
+    }
+    else if (field == copp_policer_pir_field)
+    {
+        attr.id = SAI_POLICER_ATTR_PIR;
+        attr.value.u64 = stoul(value);
+    }
+    else if (field == copp_policer_action_green_field)
+    {
+        attr.id = SAI_POLICER_ATTR_GREEN_PACKET_ACTION;
+        attr.value.s32 = packet_action_map.at(value);
+    }
+    else if (field == copp_policer_action_red_field)
+    {
+        attr.id = SAI_POLICER_ATTR_RED_PACKET_ACTION;
+        attr.value.s32 = packet_action_map.at(value);
+    }
+    else if (field == copp_policer_action_yellow_field)
+    {
+        attr.id = SAI_POLICER_ATTR_YELLOW_PACKET_ACTION;
+        attr.value.s32 = packet_action_map.at(value);
+    }
+    else
+    {
+        return false;
+    }
+
+    return true;
+}
+
+static const set<string> policer_fields = {
+    copp_policer_meter_type_field,
+    copp_policer_mode_field,
+    copp_policer_color_field,
+    copp_policer_cbs_field,
+    copp_policer_cir_field,
+    copp_policer_pbs_field,
+    copp_policer_pir_field,
+    copp_policer_action_green_field,
+    copp_policer_action_red_field,
+    copp_policer_action_yellow_field
+};
+
+/* Policer attributes that cannot be changed on an existing policer */
+static const set<string> policer_create_only_fields = {
+    copp_policer_meter_type_field,
+    copp_policer_mode_field,
+    copp_policer_color_field
+};
+
+static const vector<pair<sai_policer_stat_t, string>> policerStatIds =
+{
+    { SAI_POLICER_STAT_PACKETS,         "SAI_POLICER_STAT_PACKETS" },
+    { SAI_POLICER_STAT_ATTR_BYTES,      "SAI_POLICER_STAT_ATTR_BYTES" },
+    { SAI_POLICER_STAT_GREEN_PACKETS,   "SAI_POLICER_STAT_GREEN_PACKETS" },
+    { SAI_POLICER_STAT_GREEN_BYTES,     "SAI_POLICER_STAT_GREEN_BYTES" },
+    { SAI_POLICER_STAT_YELLOW_PACKETS,  "SAI_POLICER_STAT_YELLOW_PACKETS" },
+    { SAI_POLICER_STAT_YELLOW_BYTES,    "SAI_POLICER_STAT_YELLOW_BYTES" },
+    { SAI_POLICER_STAT_RED_PACKETS,     "SAI_POLICER_STAT_RED_PACKETS" },
+    { SAI_POLICER_STAT_RED_BYTES,       "SAI_POLICER_STAT_RED_BYTES" },
+};
+
+static sai_status_t getPolicerStats(sai_object_id_t id, uint32_t count, const int32_t *counterIds, uint64_t *counters)
+{
+    return sai_policer_api->get_policer_stats(id, count, reinterpret_cast<const sai_policer_stat_t *>(counterIds), counters);
+}
+
 const string default_trap_group = "default";
 const vector<sai_hostif_trap_type_t> default_trap_ids = {
     SAI_HOSTIF_TRAP_TYPE_TTL_ERROR
@@ -90,6 +192,11 @@ CoppOrch::CoppOrch(DBConnector *db, string tableName) :
 {
     SWSS_LOG_ENTER();
 
+    m_countersDb = unique_ptr<DBConnector>(new DBConnector(COUNTERS_DB, DBConnector::DEFAULT_UNIXSOCKET, 0));
+    m_coppNameMapTable = unique_ptr<Table>(new Table(m_countersDb.get(), COUNTERS_COPP_NAME_MAP));
+
+    gCounterPollOrch->addGroup(COUNTER_POLL_GROUP_COPP, getPolicerStats, policerStatIds, true);
+
     initDefaultHostIntfTable();
     initDefaultTrapGroup();
     initDefaultTrapIds();
@@ -146,7 +253,8 @@ void CoppOrch::initDefaultTrapIds()
         trap_id_attrs.push_back(attr);
     }
 
-    if (!applyAttributesToTrapIds(m_trap_group_map[default_trap_group], default_trap_ids, trap_id_attrs))
+    set<sai_hostif_trap_type_t> trap_ids(default_trap_ids.begin(), default_trap_ids.end());
+    if (!applyAttributesToTrapIds(m_trap_group_map[default_trap_group], trap_ids, trap_id_attrs))
     {
         SWSS_LOG_ERROR("Failed to set attributes to default trap IDs");
         throw "CoppOrch initialization failure";
@@ -173,7 +281,7 @@ void CoppOrch::initDefaultTrapGroup()
     m_trap_group_map[default_trap_group] = attr.value.oid;
 }
 
-void CoppOrch::getTrapIdList(vector<string> &trap_id_name_list, vector<sai_hostif_trap_type_t> &trap_id_list) const
+void CoppOrch::getTrapIdList(const vector<string> &trap_id_name_list, set<sai_hostif_trap_type_t> &trap_id_list) const
 {
     SWSS_LOG_ENTER();
     for (auto trap_id_str : trap_id_name_list)
@@ -182,16 +290,36 @@ void CoppOrch::getTrapIdList(vector<string> &trap_id_name_list, vector<sai_hosti
         SWSS_LOG_DEBUG("processing trap_id:%s", trap_id_str.c_str());
         trap_id = trap_id_map.at(trap_id_str);
         SWSS_LOG_DEBUG("Pushing trap_id:%d", trap_id);
-        trap_id_list.push_back(trap_id);
+        trap_id_list.insert(trap_id);
     }
 }
 
+/*
+ * Create the trap IDs that do not exist yet and set the given attributes on
+ * the existing ones, instead of creating a second trap for the same type.
+ */
 bool CoppOrch::applyAttributesToTrapIds(sai_object_id_t trap_group_id,
-                                        const vector<sai_hostif_trap_type_t> &trap_id_list,
-                                        vector<sai_attribute_t> &trap_id_attribs)
+                                        const set<sai_hostif_trap_type_t> &trap_id_list,
+                                        const vector<sai_attribute_t> &trap_id_attribs)
 {
     for (auto trap_id : trap_id_list)
     {
+        auto trap_object = m_trapObjects.find(trap_id);
+        if (trap_object != m_trapObjects.end())
+        {
+            for (auto attr : trap_id_attribs)
+            {
+                sai_status_t status = sai_hostif_api->set_hostif_trap_attribute(trap_object->second, &attr);
+                if (status != SAI_STATUS_SUCCESS)
+                {
+                    SWSS_LOG_ERROR("Failed to set attribute %d to trap %d, rv:%d", attr.id, trap_id, status);
+                    return false;
+                }
+            }
+            m_syncdTrapIds[trap_id] = trap_group_id;
+            continue;
+        }
+
         sai_attribute_t attr;
         vector<sai_attribute_t> attrs;
 
@@ -208,26 +336,125 @@ bool CoppOrch::applyAttributesToTrapIds(sai_object_id_t trap_group_id,
             SWSS_LOG_ERROR("Failed to create trap %d, rv:%d", trap_id, status);
             return false;
         }
-        m_syncdTrapIds[trap_id] = hostif_trap_id;
+        m_trapObjects[trap_id] = hostif_trap_id;
+        m_syncdTrapIds[trap_id] = trap_group_id;
     }
 
     return true;
 }
 
-bool CoppOrch::applyTrapIds(sai_object_id_t trap_group, vector<string> &trap_id_name_list, vector<sai_attribute_t> &trap_id_attribs)
+/* Move trap IDs back to the default trap group with default attributes */
+bool CoppOrch::resetTrapIds(const set<sai_hostif_trap_type_t> &trap_id_list)
 {
     SWSS_LOG_ENTER();
 
-    vector<sai_hostif_trap_type_t> trap_id_list;
-
-    getTrapIdList(trap_id_name_list, trap_id_list);
+    if (trap_id_list.empty())
+    {
+        return true;
+    }
 
     sai_attribute_t attr;
+    vector<sai_attribute_t> default_trap_attrs;
+
+    attr.id = SAI_HOSTIF_TRAP_ATTR_PACKET_ACTION;
+    attr.value.s32 = SAI_PACKET_ACTION_FORWARD;
+    default_trap_attrs.push_back(attr);
+
     attr.id = SAI_HOSTIF_TRAP_ATTR_TRAP_GROUP;
-    attr.value.oid = trap_group;
-    trap_id_attribs.push_back(attr);
+    attr.value.oid = m_trap_group_map[default_trap_group];
+    default_trap_attrs.push_back(attr);
+
+    return applyAttributesToTrapIds(m_trap_group_map[default_trap_group], trap_id_list, default_trap_attrs);
+}
+
+/*
+ * Bring the policer of a trap group from the applied fields to the new ones.
+ * Changed attributes are set in place. A policer is only recreated when a
+ * create-only attribute changes or an attribute is dropped, and then the new
+ * policer is bound before the old one is removed so that the trap group is
+ * never left unpoliced.
+ */
+bool CoppOrch::applyPolicer(string trap_group_name, const CoppFieldTable &fields, const CoppFieldTable &applied)
+{
+    SWSS_LOG_ENTER();
+
+    vector<sai_attribute_t> policer_attribs;
+    vector<sai_attribute_t> changed_attribs;
+    bool recreate = false;
+
+    for (const auto &field : fields)
+    {
+        sai_attribute_t attr;
+        if (!parsePolicerAttribute(field.first, field.second, attr))
+        {
+            continue;
+        }
+        policer_attribs.push_back(attr);
 
-    return applyAttributesToTrapIds(trap_group, trap_id_list, trap_id_attribs);
+        auto old = applied.find(field.first);
+        if (old != applied.end() && old->second == field.second)
+        {
+            continue;
+        }
+
+        if (policer_create_only_fields.find(field.first) != policer_create_only_fields.end())
+        {
+            recreate = true;
+        }
+        changed_attribs.push_back(attr);
+    }
+
+    for (const auto &field : applied)
+    {
+        if (policer_fields.find(field.first) != policer_fields.end() &&
+            fields.find(field.first) == fields.end())
+        {
+            recreate = true;
+        }
+    }
+
+    if (policer_attribs.empty())
+    {
+        return removePolicer(trap_group_name);
+    }
+
+    sai_object_id_t policer_id = getPolicer(trap_group_name);
+    if (SAI_NULL_OBJECT_ID == policer_id)
+    {
+        return createPolicer(trap_group_name, policer_attribs);
+    }
+
+    if (recreate)
+    {
+        if (!createPolicer(trap_group_name, policer_attribs))
+        {
+            return false;
+        }
+
+        gCounterPollOrch->removeObject(COUNTER_POLL_GROUP_COPP, policer_id);
+
+        sai_status_t sai_status = sai_policer_api->remove_policer(policer_id);
+        if (sai_status != SAI_STATUS_SUCCESS)
+        {
+            SWSS_LOG_ERROR("Failed to remove replaced policer %lx of trap group %s, rc=%d", policer_id, trap_group_name.c_str(), sai_status);
+        }
+
+        SWSS_LOG_NOTICE("Replace policer for trap group %s", trap_group_name.c_str());
+        return true;
+    }
+
+    for (auto policer_attr : changed_attribs)
+    {
+        sai_status_t sai_status = sai_policer_api->set_policer_attribute(policer_id, &policer_attr);
+        if (sai_status != SAI_STATUS_SUCCESS)
+        {
+            SWSS_LOG_ERROR("Failed to apply attribute %d to policer for trap group:%s, error:%d", policer_attr.id, trap_group_name.c_str(), sai_status);
+            return false;
+        }
+        SWSS_LOG_NOTICE("Set attribute %d to policer for trap group %s", policer_attr.id, trap_group_name.c_str());
+    }
+
+    return true;
 }
 
 bool CoppOrch::removePolicer(string trap_group_name)
@@ -254,10 +481,14 @@ bool CoppOrch::removePolicer(string trap_group_name)
         return false;
     }
 
+    /* Stop polling the policer before it is removed */
+    removePolicerCounters(trap_group_name, policer_id);
+
     sai_status = sai_policer_api->remove_policer(policer_id);
     if (sai_status != SAI_STATUS_SUCCESS)
     {
         SWSS_LOG_ERROR("Failed to remove policer for trap group %s, rc=%d", trap_group_name.c_str(), sai_status);
+        addPolicerCounters(trap_group_name, policer_id);
         return false;
     }
 
@@ -313,174 +544,137 @@ bool CoppOrch::createPolicer(string trap_group_name, vector<sai_attribute_t> &po
 
     SWSS_LOG_NOTICE("Bind policer to trap group %s:", trap_group_name.c_str());
     m_trap_group_policer_map[m_trap_group_map[trap_group_name]] = policer_id;
+    addPolicerCounters(trap_group_name, policer_id);
     return true;
 }
 
-task_process_status CoppOrch::processCoppRule(Consumer& consumer)
+void CoppOrch::addPolicerCounters(string trap_group_name, sai_object_id_t policer_id)
+{
+    SWSS_LOG_ENTER();
+
+    vector<FieldValueTuple> fieldValues;
+    fieldValues.emplace_back(trap_group_name, sai_serialize_object_id(policer_id));
+    m_coppNameMapTable->set("", fieldValues);
+
+    gCounterPollOrch->addObject(COUNTER_POLL_GROUP_COPP, policer_id);
+}
+
+void CoppOrch::removePolicerCounters(string trap_group_name, sai_object_id_t policer_id)
+{
+    SWSS_LOG_ENTER();
+
+    gCounterPollOrch->removeObject(COUNTER_POLL_GROUP_COPP, policer_id);
+
+    m_coppNameMapTable->hdel("", trap_group_name);
+}
+
+/*
+ * Trap groups are applied as a diff against the fields of the last
+ * successful SET: only changed trap group and policer attributes are set, and
+ * trap IDs are only programmed when they join or leave the group or when
+ * their action or priority changes.
+ */
+task_process_status CoppOrch::processCoppRule(KeyOpFieldsValuesTuple &tuple)
 {
     SWSS_LOG_ENTER();
 
     sai_status_t sai_status;
-    vector<string> trap_id_list;
-    string queue_ind;
-    auto it = consumer.m_toSync.begin();
-    KeyOpFieldsValuesTuple tuple = it->second;
     string trap_group_name = kfvKey(tuple);
     string op = kfvOp(tuple);
 
-    vector<sai_attribute_t> trap_gr_attribs;
-    vector<sai_attribute_t> trap_id_attribs;
-    vector<sai_attribute_t> policer_attribs;
-
     if (op == SET_COMMAND)
     {
+        CoppFieldTable fields;
         for (auto i = kfvFieldsValues(tuple).begin(); i != kfvFieldsValues(tuple).end(); i++)
         {
             sai_attribute_t attr;
 
-            if (fvField(*i) == copp_trap_id_list)
-            {
-                trap_id_list = tokenize(fvValue(*i), list_item_delimiter);
-            }
-            else if (fvField(*i) == copp_queue_field)
-            {
-                attr.id = SAI_HOSTIF_TRAP_GROUP_ATTR_QUEUE;
-                attr.value.u32 = (uint32_t)stoul(fvValue(*i));
-                trap_gr_attribs.push_back(attr);
-            }
-            //
-            // Trap related attributes
-            //
-            else if (fvField(*i) == copp_trap_action_field)
-            {
-                sai_packet_action_t trap_action = packet_action_map.at(fvValue(*i));
-                attr.id = SAI_HOSTIF_TRAP_ATTR_PACKET_ACTION;
-                attr.value.s32 = trap_action;
-                trap_id_attribs.push_back(attr);
-            }
-            else if (fvField(*i) == copp_trap_priority_field)
-            {
-                /* Mellanox platform doesn't support trap priority setting */
-                char *platform = getenv("platform");
-                if (!platform || !strstr(platform, MLNX_PLATFORM_SUBSTRING))
-                {
-                    attr.id = SAI_HOSTIF_TRAP_ATTR_TRAP_PRIORITY,
-                    attr.value.u32 = (uint32_t)stoul(fvValue(*i));
-                    trap_id_attribs.push_back(attr);
-                }
-            }
-            //
-            // process policer attributes
-            //
-            else if (fvField(*i) == copp_policer_meter_type_field)
-            {
-                sai_meter_type_t meter_value = policer_meter_map.at(fvValue(*i));
-                attr.id = SAI_POLICER_ATTR_METER_TYPE;
-                attr.value.s32 = meter_value;
-                policer_attribs.push_back(attr);
-            }
-            else if (fvField(*i) == copp_policer_mode_field)
+            if (fvField(*i) != copp_trap_id_list &&
+                fvField(*i) != copp_queue_field &&
+                fvField(*i) != copp_trap_action_field &&
+                fvField(*i) != copp_trap_priority_field &&
+                !parsePolicerAttribute(fvField(*i), fvValue(*i), attr))
             {
-                sai_policer_mode_t mode = policer_mode_map.at(fvValue(*i));
-                attr.id = SAI_POLICER_ATTR_MODE;
-                attr.value.s32 = mode;
-                policer_attribs.push_back(attr);
-            }
-            else if (fvField(*i) == copp_policer_color_field)
-            {
-                sai_policer_color_source_t color = policer_color_aware_map.at(fvValue(*i));
-                attr.id = SAI_POLICER_ATTR_COLOR_SOURCE;
-                attr.value.s32 = color;
-                policer_attribs.push_back(attr);
-            }
-            else if (fvField(*i) == copp_policer_cbs_field)
-            {
-                attr.id = SAI_POLICER_ATTR_CBS;
-                attr.value.u64 = stoul(fvValue(*i));
-                policer_attribs.push_back(attr);
-            }
-            else if (fvField(*i) == copp_policer_cir_field)
-            {
-                attr.id = SAI_POLICER_ATTR_CIR;
-                attr.value.u64 = stoul(fvValue(*i));
-                policer_attribs.push_back(attr);
-            }
-            else if (fvField(*i) == copp_policer_pbs_field)
-            {
-                attr.id = SAI_POLICER_ATTR_PBS;
-                attr.value.u64 = stoul(fvValue(*i));
-                policer_attribs.push_back(attr);
-            }
-            else if (fvField(*i) == copp_policer_pir_field)
-            {
-                attr.id = SAI_POLICER_ATTR_PIR;
-                attr.value.u64 = stoul(fvValue(*i));
-                policer_attribs.push_back(attr);
-            }
-            else if (fvField(*i) == copp_policer_action_green_field)
-            {
-                sai_packet_action_t policer_action = packet_action_map.at(fvValue(*i));
-                attr.id = SAI_POLICER_ATTR_GREEN_PACKET_ACTION;
-                attr.value.s32 = policer_action;
-                policer_attribs.push_back(attr);
+                SWSS_LOG_ERROR("Unknown copp field specified:%s\n", fvField(*i).c_str());
+                return task_process_status::task_invalid_entry;
             }
-            else if (fvField(*i) == copp_policer_action_red_field)
+            fields[fvField(*i)] = fvValue(*i);
+        }
+
+        CoppFieldTable applied;
+        if (m_appliedFields.find(trap_group_name) != m_appliedFields.end())
+        {
+            applied = m_appliedFields[trap_group_name];
+        }
+
+        auto changed = [&](const string &field)
+        {
+            auto new_field = fields.find(field);
+            auto old_field = applied.find(field);
+            if (new_field == fields.end())
             {
-                sai_packet_action_t policer_action = packet_action_map.at(fvValue(*i));
-                attr.id = SAI_POLICER_ATTR_RED_PACKET_ACTION;
-                attr.value.s32 = policer_action;
-                policer_attribs.push_back(attr);
+                return old_field != applied.end();
             }
-            else if (fvField(*i) == copp_policer_action_yellow_field)
+            return old_field == applied.end() || old_field->second != new_field->second;
+        };
+
+        set<sai_hostif_trap_type_t> trap_ids;
+        set<sai_hostif_trap_type_t> applied_trap_ids;
+        if (fields.find(copp_trap_id_list) != fields.end())
+        {
+            getTrapIdList(tokenize(fields[copp_trap_id_list], list_item_delimiter), trap_ids);
+        }
+        if (applied.find(copp_trap_id_list) != applied.end())
+        {
+            getTrapIdList(tokenize(applied[copp_trap_id_list], list_item_delimiter), applied_trap_ids);
+        }
+
+        sai_attribute_t attr;
+        vector<sai_attribute_t> trap_gr_attribs;
+        vector<sai_attribute_t> trap_id_attribs;
+        vector<sai_attribute_t> changed_trap_id_attribs;
+
+        if (fields.find(copp_queue_field) != fields.end())
+        {
+            attr.id = SAI_HOSTIF_TRAP_GROUP_ATTR_QUEUE;
+            attr.value.u32 = (uint32_t)stoul(fields[copp_queue_field]);
+            trap_gr_attribs.push_back(attr);
+        }
+
+        //
+        // Trap related attributes
+        //
+        if (fields.find(copp_trap_action_field) != fields.end())
+        {
+            attr.id = SAI_HOSTIF_TRAP_ATTR_PACKET_ACTION;
+            attr.value.s32 = packet_action_map.at(fields[copp_trap_action_field]);
+            trap_id_attribs.push_back(attr);
+            if (changed(copp_trap_action_field))
             {
-                sai_packet_action_t policer_action = packet_action_map.at(fvValue(*i));
-                attr.id = SAI_POLICER_ATTR_YELLOW_PACKET_ACTION;
-                attr.value.s32 = policer_action;
-                policer_attribs.push_back(attr);
+                changed_trap_id_attribs.push_back(attr);
             }
-            else
+        }
+
+        /* Mellanox platform doesn't support trap priority setting */
+        char *platform = getenv("platform");
+        if (fields.find(copp_trap_priority_field) != fields.end() &&
+            (!platform || !strstr(platform, MLNX_PLATFORM_SUBSTRING)))
+        {
+            attr.id = SAI_HOSTIF_TRAP_ATTR_TRAP_PRIORITY;
+            attr.value.u32 = (uint32_t)stoul(fields[copp_trap_priority_field]);
+            trap_id_attribs.push_back(attr);
+            if (changed(copp_trap_priority_field))
             {
-                SWSS_LOG_ERROR("Unknown copp field specified:%s\n", fvField(*i).c_str());
-                return task_process_status::task_invalid_entry;
+                changed_trap_id_attribs.push_back(attr);
             }
         }
 
         /* Set host interface trap group */
         if (m_trap_group_map.find(trap_group_name) != m_trap_group_map.end())
         {
-            /* Create or set policer */
-            if (!policer_attribs.empty())
-            {
-                sai_object_id_t policer_id = getPolicer(trap_group_name);
-                if (SAI_NULL_OBJECT_ID == policer_id)
-                {
-                    SWSS_LOG_WARN("Creating policer for existing Trap group:%lx (name:%s).", m_trap_group_map[trap_group_name], trap_group_name.c_str());
-                    if (!createPolicer(trap_group_name, policer_attribs))
-                    {
-                        return task_process_status::task_failed;
-                    }
-                    SWSS_LOG_DEBUG("Created policer:%lx for existing trap group", policer_id);
-                }
-                else
-                {
-                /* TODO: We should really only set changed attributes.
-                The changes need to detected either by orch agent submodule or by the orch agent framework. */
-                    for (sai_uint32_t ind = 0; ind < policer_attribs.size(); ind++)
-                    {
-                        auto policer_attr = policer_attribs[ind];
-                        sai_status = sai_policer_api->set_policer_attribute(policer_id, &policer_attr);
-                        if (sai_status != SAI_STATUS_SUCCESS)
-                        {
-                            SWSS_LOG_ERROR("Failed to apply attribute[%d].id=%d to policer for trap group:%s, error:%d\n", ind, policer_attr.id, trap_group_name.c_str(), sai_status);
-                            return task_process_status::task_failed;
-                        }
-                    }
-                }
-            }
-
-            for (sai_uint32_t ind = 0; ind < trap_gr_attribs.size(); ind++)
+            if (changed(copp_queue_field) && !trap_gr_attribs.empty())
             {
-                auto trap_gr_attr = trap_gr_attribs[ind];
+                auto trap_gr_attr = trap_gr_attribs[0];
 
                 sai_status = sai_hostif_api->set_hostif_trap_group_attribute(m_trap_group_map[trap_group_name], &trap_gr_attr);
                 if (sai_status != SAI_STATUS_SUCCESS)
@@ -505,22 +699,67 @@ task_process_status CoppOrch::processCoppRule(Consumer& consumer)
 
             SWSS_LOG_NOTICE("Create host interface trap group %s", trap_group_name.c_str());
             m_trap_group_map[trap_group_name] = new_trap;
+        }
+
+        /* Create, set or remove policer */
+        if (!applyPolicer(trap_group_name, fields, applied))
+        {
+            return task_process_status::task_failed;
+        }
+
+        sai_object_id_t trap_group_id = m_trap_group_map[trap_group_name];
 
-            /* Create policer */
-            if (!policer_attribs.empty())
+        /* Trap IDs that left the group go back to the default trap group */
+        set<sai_hostif_trap_type_t> removed_trap_ids;
+        for (auto trap_id : applied_trap_ids)
+        {
+            auto syncd = m_syncdTrapIds.find(trap_id);
+            if (trap_ids.find(trap_id) == trap_ids.end() &&
+                syncd != m_syncdTrapIds.end() && syncd->second == trap_group_id)
             {
-                if (!createPolicer(trap_group_name, policer_attribs))
-                {
-                    return task_process_status::task_failed;
-                }
+                removed_trap_ids.insert(trap_id);
             }
         }
 
+        set<sai_hostif_trap_type_t> added_trap_ids;
+        set<sai_hostif_trap_type_t> kept_trap_ids;
+        for (auto trap_id : trap_ids)
+        {
+            auto syncd = m_syncdTrapIds.find(trap_id);
+            if (applied_trap_ids.find(trap_id) != applied_trap_ids.end() &&
+                syncd != m_syncdTrapIds.end() && syncd->second == trap_group_id)
+            {
+                kept_trap_ids.insert(trap_id);
+            }
+            else
+            {
+                added_trap_ids.insert(trap_id);
+            }
+        }
+
+        if (!resetTrapIds(removed_trap_ids))
+        {
+            SWSS_LOG_ERROR("Failed to reset traps to default trap group with default attributes");
+            return task_process_status::task_failed;
+        }
+
         /* Apply traps to trap group */
-        if (!applyTrapIds(m_trap_group_map[trap_group_name], trap_id_list, trap_id_attribs))
+        attr.id = SAI_HOSTIF_TRAP_ATTR_TRAP_GROUP;
+        attr.value.oid = trap_group_id;
+        trap_id_attribs.push_back(attr);
+
+        if (!applyAttributesToTrapIds(trap_group_id, added_trap_ids, trap_id_attribs))
         {
             return task_process_status::task_failed;
         }
+
+        if (!changed_trap_id_attribs.empty() &&
+            !applyAttributesToTrapIds(trap_group_id, kept_trap_ids, changed_trap_id_attribs))
+        {
+            return task_process_status::task_failed;
+        }
+
+        m_appliedFields[trap_group_name] = fields;
     }
     else if (op == DEL_COMMAND)
     {
@@ -534,32 +773,27 @@ task_process_status CoppOrch::processCoppRule(Consumer& consumer)
         /* Do not remove default trap group */
         if (trap_group_name == default_trap_group)
         {
+            auto &applied = m_appliedFields[trap_group_name];
+            for (const auto &field : policer_fields)
+            {
+                applied.erase(field);
+            }
+
             SWSS_LOG_WARN("Cannot remove default trap group");
             return task_process_status::task_ignore;
         }
 
         /* Reset the trap IDs to default trap group with default attributes */
-        vector<sai_hostif_trap_type_t> trap_ids_to_reset;
+        set<sai_hostif_trap_type_t> trap_ids_to_reset;
         for (auto it : m_syncdTrapIds)
         {
             if (it.second == m_trap_group_map[trap_group_name])
             {
-                trap_ids_to_reset.push_back(it.first);
+                trap_ids_to_reset.insert(it.first);
             }
         }
 
-        sai_attribute_t attr;
-        vector<sai_attribute_t> default_trap_attrs;
-
-        attr.id = SAI_HOSTIF_TRAP_ATTR_PACKET_ACTION;
-        attr.value.s32 = SAI_PACKET_ACTION_FORWARD;
-        default_trap_attrs.push_back(attr);
-
-        attr.id = SAI_HOSTIF_TRAP_ATTR_TRAP_GROUP;
-        attr.value.oid = m_trap_group_map[default_trap_group];
-        default_trap_attrs.push_back(attr);
-
-        if (!applyAttributesToTrapIds(m_trap_group_map[default_trap_group], trap_ids_to_reset, default_trap_attrs))
+        if (!resetTrapIds(trap_ids_to_reset))
         {
             SWSS_LOG_ERROR("Failed to reset traps to default trap group with default attributes");
             return task_process_status::task_failed;
@@ -574,6 +808,7 @@ task_process_status CoppOrch::processCoppRule(Consumer& consumer)
 
         auto it_del = m_trap_group_map.find(trap_group_name);
         m_trap_group_map.erase(it_del);
+        m_appliedFields.erase(trap_group_name);
     }
     else
     {
@@ -590,12 +825,12 @@ void CoppOrch::doTask(Consumer &consumer)
     auto it = consumer.m_toSync.begin();
     while (it != consumer.m_toSync.end())
     {
-        KeyOpFieldsValuesTuple tuple = it->second;
+        KeyOpFieldsValuesTuple &tuple = it->second;
         task_process_status task_status;
 
         try
         {
-            task_status = processCoppRule(consumer);
+            task_status = processCoppRule(tuple);
         }
         catch(const out_of_range e)
         {
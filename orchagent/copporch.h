@@ -5,6 +5,9 @@
 #include <set>
 #include "orch.h"
 
+/* Trap group name to policer id map of the COPP counter group */
+#define COUNTERS_COPP_NAME_MAP  "COUNTERS_COPP_NAME_MAP"
+
 // trap fields
 const string copp_trap_id_list                = "trap_ids";
 const string copp_trap_action_field           = "trap_action";
@@ -24,10 +27,21 @@ const string copp_policer_action_green_field  = "green_action";
 const string copp_policer_action_red_field    = "red_action";
 const string copp_policer_action_yellow_field = "yellow_action";
 
+/*
+ * Translate a policer field into the corresponding SAI policer attribute.
+ * Returns false if the field is not a policer field. Throws out_of_range on
+ * unknown enumeration values.
+ */
+bool parsePolicerAttribute(const string &field, const string &value, sai_attribute_t &attr);
+
 /* TrapGroupPolicerTable: trap group ID, policer ID */
 typedef map<sai_object_id_t, sai_object_id_t> TrapGroupPolicerTable;
 /* TrapIdTrapGroupTable: trap ID, trap group ID */
 typedef map<sai_hostif_trap_type_t, sai_object_id_t> TrapIdTrapGroupTable;
+/* TrapIdTrapObjectTable: trap ID, host interface trap object ID */
+typedef map<sai_hostif_trap_type_t, sai_object_id_t> TrapIdTrapObjectTable;
+/* CoppFieldTable: field, value last applied to a trap group */
+typedef map<string, string> CoppFieldTable;
 
 class CoppOrch : public Orch
 {
@@ -38,22 +52,32 @@ protected:
 
     TrapGroupPolicerTable m_trap_group_policer_map;
     TrapIdTrapGroupTable m_syncdTrapIds;
+    TrapIdTrapObjectTable m_trapObjects;
+    /* Trap group name, fields applied on the last successful SET */
+    map<string, CoppFieldTable> m_appliedFields;
 
     void initDefaultHostIntfTable();
     void initDefaultTrapGroup();
     void initDefaultTrapIds();
 
-    task_process_status processCoppRule(Consumer& consumer);
+    task_process_status processCoppRule(KeyOpFieldsValuesTuple &tuple);
     bool isValidList(vector<string> &trap_id_list, vector<string> &all_items) const;
-    void getTrapIdList(vector<string> &trap_id_name_list, vector<sai_hostif_trap_type_t> &trap_id_list) const;
-    bool applyTrapIds(sai_object_id_t trap_group, vector<string> &trap_id_name_list, vector<sai_attribute_t> &trap_id_attribs);
-    bool applyAttributesToTrapIds(sai_object_id_t trap_group_id, const vector<sai_hostif_trap_type_t> &trap_id_list, vector<sai_attribute_t> &trap_id_attribs);
+    void getTrapIdList(const vector<string> &trap_id_name_list, set<sai_hostif_trap_type_t> &trap_id_list) const;
+    bool applyAttributesToTrapIds(sai_object_id_t trap_group_id, const set<sai_hostif_trap_type_t> &trap_id_list, const vector<sai_attribute_t> &trap_id_attribs);
+    bool resetTrapIds(const set<sai_hostif_trap_type_t> &trap_id_list);
 
+    bool applyPolicer(string trap_group_name, const CoppFieldTable &fields, const CoppFieldTable &applied);
     bool createPolicer(string trap_group, vector<sai_attribute_t> &policer_attribs);
     bool removePolicer(string trap_group_name);
 
     sai_object_id_t getPolicer(string trap_group_name);
 
+    unique_ptr<DBConnector> m_countersDb;
+    unique_ptr<Table> m_coppNameMapTable;
+
+    void addPolicerCounters(string trap_group_name, sai_object_id_t policer_id);
+    void removePolicerCounters(string trap_group_name, sai_object_id_t policer_id);
+
     virtual void doTask(Consumer& consumer);
 };
 #endif /* SWSS_COPPORCH_H */
@@ -0,0 +1,554 @@
+#include <algorithm>
+
+#include "counterpollorch.h"
+#include "logger.h"
+#include "saiserialize.h"
+
+extern sai_port_api_t *sai_port_api;
+extern sai_queue_api_t *sai_queue_api;
+extern sai_buffer_api_t *sai_buffer_api;
+
+extern PortsOrch *gPortsOrch;
+
+static const vector<pair<sai_port_stat_t, string>> portStatIds =
+{
+    { SAI_PORT_STAT_IF_IN_OCTETS,               "SAI_PORT_STAT_IF_IN_OCTETS" },
+    { SAI_PORT_STAT_IF_IN_UCAST_PKTS,           "SAI_PORT_STAT_IF_IN_UCAST_PKTS" },
+    { SAI_PORT_STAT_IF_IN_NON_UCAST_PKTS,       "SAI_PORT_STAT_IF_IN_NON_UCAST_PKTS" },
+    { SAI_PORT_STAT_IF_IN_DISCARDS,             "SAI_PORT_STAT_IF_IN_DISCARDS" },
+    { SAI_PORT_STAT_IF_IN_ERRORS,               "SAI_PORT_STAT_IF_IN_ERRORS" },
+    { SAI_PORT_STAT_IF_IN_UNKNOWN_PROTOS,       "SAI_PORT_STAT_IF_IN_UNKNOWN_PROTOS" },
+    { SAI_PORT_STAT_IF_OUT_OCTETS,              "SAI_PORT_STAT_IF_OUT_OCTETS" },
+    { SAI_PORT_STAT_IF_OUT_UCAST_PKTS,          "SAI_PORT_STAT_IF_OUT_UCAST_PKTS" },
+    { SAI_PORT_STAT_IF_OUT_NON_UCAST_PKTS,      "SAI_PORT_STAT_IF_OUT_NON_UCAST_PKTS" },
+    { SAI_PORT_STAT_IF_OUT_DISCARDS,            "SAI_PORT_STAT_IF_OUT_DISCARDS" },
+    { SAI_PORT_STAT_IF_OUT_ERRORS,              "SAI_PORT_STAT_IF_OUT_ERRORS" },
+    { SAI_PORT_STAT_IF_OUT_QLEN,                "SAI_PORT_STAT_IF_OUT_QLEN" },
+    { SAI_PORT_STAT_PFC_0_RX_PKTS,              "SAI_PORT_STAT_PFC_0_RX_PKTS" },
+    { SAI_PORT_STAT_PFC_1_RX_PKTS,              "SAI_PORT_STAT_PFC_1_RX_PKTS" },
+    { SAI_PORT_STAT_PFC_2_RX_PKTS,              "SAI_PORT_STAT_PFC_2_RX_PKTS" },
+    { SAI_PORT_STAT_PFC_3_RX_PKTS,              "SAI_PORT_STAT_PFC_3_RX_PKTS" },
+    { SAI_PORT_STAT_PFC_4_RX_PKTS,              "SAI_PORT_STAT_PFC_4_RX_PKTS" },
+    { SAI_PORT_STAT_PFC_5_RX_PKTS,              "SAI_PORT_STAT_PFC_5_RX_PKTS" },
+    { SAI_PORT_STAT_PFC_6_RX_PKTS,              "SAI_PORT_STAT_PFC_6_RX_PKTS" },
+    { SAI_PORT_STAT_PFC_7_RX_PKTS,              "SAI_PORT_STAT_PFC_7_RX_PKTS" },
+    { SAI_PORT_STAT_PFC_0_TX_PKTS,              "SAI_PORT_STAT_PFC_0_TX_PKTS" },
+    { SAI_PORT_STAT_PFC_1_TX_PKTS,              "SAI_PORT_STAT_PFC_1_TX_PKTS" },
+    { SAI_PORT_STAT_PFC_2_TX_PKTS,              "SAI_PORT_STAT_PFC_2_TX_PKTS" },
+    { SAI_PORT_STAT_PFC_3_TX_PKTS,              "SAI_PORT_STAT_PFC_3_TX_PKTS" },
+    { SAI_PORT_STAT_PFC_4_TX_PKTS,              "SAI_PORT_STAT_PFC_4_TX_PKTS" },
+    { SAI_PORT_STAT_PFC_5_TX_PKTS,              "SAI_PORT_STAT_PFC_5_TX_PKTS" },
+    { SAI_PORT_STAT_PFC_6_TX_PKTS,              "SAI_PORT_STAT_PFC_6_TX_PKTS" },
+    { SAI_PORT_STAT_PFC_7_TX_PKTS,              "SAI_PORT_STAT_PFC_7_TX_PKTS" },
+};
+
+static const vector<pair<sai_queue_stat_t, string>> queueStatIds =
+{
+    { SAI_QUEUE_STAT_PACKETS,                   "SAI_QUEUE_STAT_PACKETS" },
+    { SAI_QUEUE_STAT_BYTES,                     "SAI_QUEUE_STAT_BYTES" },
+    { SAI_QUEUE_STAT_DROPPED_PACKETS,           "SAI_QUEUE_STAT_DROPPED_PACKETS" },
+    { SAI_QUEUE_STAT_DROPPED_BYTES,             "SAI_QUEUE_STAT_DROPPED_BYTES" },
+};
+
+static const vector<pair<sai_ingress_priority_group_stat_t, string>> pgStatIds =
+{
+    { SAI_INGRESS_PRIORITY_GROUP_STAT_PACKETS,  "SAI_INGRESS_PRIORITY_GROUP_STAT_PACKETS" },
+    { SAI_INGRESS_PRIORITY_GROUP_STAT_BYTES,    "SAI_INGRESS_PRIORITY_GROUP_STAT_BYTES" },
+};
+
+static sai_status_t getPortStats(sai_object_id_t id, uint32_t count, const int32_t *counterIds, uint64_t *counters)
+{
+    return sai_port_api->get_port_stats(id, count, reinterpret_cast<const sai_port_stat_t *>(counterIds), counters);
+}
+
+static sai_status_t getQueueStats(sai_object_id_t id, uint32_t count, const int32_t *counterIds, uint64_t *counters)
+{
+    return sai_queue_api->get_queue_stats(id, count, reinterpret_cast<const sai_queue_stat_t *>(counterIds), counters);
+}
+
+static sai_status_t getPgStats(sai_object_id_t id, uint32_t count, const int32_t *counterIds, uint64_t *counters)
+{
+    return sai_buffer_api->get_ingress_priority_group_stats(id, count,
+            reinterpret_cast<const sai_ingress_priority_group_stat_t *>(counterIds), counters);
+}
+
+CounterPollOrch::CounterPollOrch(DBConnector *db, string tableName) :
+        Orch(db, tableName)
+{
+    SWSS_LOG_ENTER();
+
+    m_countersDb = unique_ptr<DBConnector>(new DBConnector(COUNTERS_DB, DBConnector::DEFAULT_UNIXSOCKET, 0));
+    m_countersTable = unique_ptr<Table>(new Table(m_countersDb.get(), COUNTERS_TABLE));
+    m_queueNameMapTable = unique_ptr<Table>(new Table(m_countersDb.get(), COUNTERS_QUEUE_NAME_MAP));
+    m_pgNameMapTable = unique_ptr<Table>(new Table(m_countersDb.get(), COUNTERS_PG_NAME_MAP));
+
+    m_groups[COUNTER_POLL_GROUP_PORT].getStats = getPortStats;
+    m_groups[COUNTER_POLL_GROUP_QUEUE].getStats = getQueueStats;
+    m_groups[COUNTER_POLL_GROUP_PG].getStats = getPgStats;
+
+    m_pollThread = thread(&CounterPollOrch::pollCountersThread, this);
+}
+
+CounterPollOrch::~CounterPollOrch()
+{
+    {
+        unique_lock<mutex> lock(m_pollMutex);
+        m_pollCounters = false;
+    }
+    m_sleepGuard.notify_all();
+
+    if (m_pollThread.joinable())
+    {
+        m_pollThread.join();
+    }
+}
+
+void CounterPollOrch::doTask(Consumer &consumer)
+{
+    SWSS_LOG_ENTER();
+
+    /* Queues and priority groups are known once all the ports are created */
+    if (!gPortsOrch->isInitDone())
+    {
+        return;
+    }
+
+    auto it = consumer.m_toSync.begin();
+    while (it != consumer.m_toSync.end())
+    {
+        KeyOpFieldsValuesTuple t = it->second;
+        string key = kfvKey(t);
+        string op = kfvOp(t);
+
+        unique_lock<mutex> lock(m_pollMutex);
+
+        auto group_it = m_groups.find(key);
+        if (group_it == m_groups.end())
+        {
+            SWSS_LOG_ERROR("Unknown counter group %s", key.c_str());
+            it = consumer.m_toSync.erase(it);
+            continue;
+        }
+        CounterPollGroup &group = group_it->second;
+
+        if (op == SET_COMMAND)
+        {
+            string status;
+            unsigned long interval = 0;
+            bool valid = true;
+            for (auto i : kfvFieldsValues(t))
+            {
+                if (fvField(i) == counter_poll_interval_field_name)
+                {
+                    try
+                    {
+                        interval = stoul(fvValue(i));
+                    }
+                    catch (const exception &)
+                    {
+                        interval = 0;
+                    }
+
+                    if (interval == 0)
+                    {
+                        SWSS_LOG_ERROR("Invalid poll interval %s of counter group %s",
+                                       fvValue(i).c_str(), key.c_str());
+                        valid = false;
+                        break;
+                    }
+                }
+                else if (fvField(i) == counter_poll_status_field_name)
+                {
+                    status = fvValue(i);
+                }
+                else
+                {
+                    SWSS_LOG_ERROR("Unknown counter group field %s", fvField(i).c_str());
+                }
+            }
+
+            if (!valid)
+            {
+                it = consumer.m_toSync.erase(it);
+                continue;
+            }
+
+            if (interval)
+            {
+                group.interval = chrono::milliseconds(interval);
+            }
+
+            if (status == counter_poll_status_enable && !group.enabled)
+            {
+                group.enabled = enableGroup(key, group);
+            }
+            else if (status == counter_poll_status_disable)
+            {
+                group.enabled = false;
+            }
+            group.nextPoll = chrono::steady_clock::now();
+
+            SWSS_LOG_NOTICE("Counter group %s %s, interval %ldms", key.c_str(),
+                            group.enabled ? "enabled" : "disabled", (long)group.interval.count());
+        }
+        else if (op == DEL_COMMAND)
+        {
+            group.enabled = false;
+            SWSS_LOG_NOTICE("Counter group %s disabled", key.c_str());
+        }
+        else
+        {
+            SWSS_LOG_ERROR("Unknown operation type %s", op.c_str());
+        }
+
+        lock.unlock();
+        m_sleepGuard.notify_all();
+
+        it = consumer.m_toSync.erase(it);
+    }
+}
+
+bool CounterPollOrch::enableGroup(const string &name, CounterPollGroup &group)
+{
+    SWSS_LOG_ENTER();
+
+    group.samples.clear();
+    group.failureLogged = false;
+
+    if (group.registered)
+    {
+        /* Probed once the first object is registered */
+        group.counterIds.clear();
+        group.counterNames.clear();
+        if (!group.objects.empty())
+        {
+            probeCounters(name, group, m_groupStatIds[name]);
+            return !group.counterIds.empty();
+        }
+        return true;
+    }
+
+    group.objects.clear();
+
+    if (name == COUNTER_POLL_GROUP_PORT)
+    {
+        addPortObjects(group);
+        probeCounters(name, group, portStatIds);
+    }
+    else if (name == COUNTER_POLL_GROUP_QUEUE)
+    {
+        addQueueObjects(group);
+        probeCounters(name, group, queueStatIds);
+    }
+    else if (name == COUNTER_POLL_GROUP_PG)
+    {
+        addPgObjects(group);
+        probeCounters(name, group, pgStatIds);
+    }
+
+    return !group.counterIds.empty();
+}
+
+void CounterPollOrch::addObject(const string &name, sai_object_id_t id)
+{
+    SWSS_LOG_ENTER();
+
+    unique_lock<mutex> lock(m_pollMutex);
+
+    auto group_it = m_groups.find(name);
+    if (group_it == m_groups.end() || !group_it->second.registered)
+    {
+        SWSS_LOG_ERROR("Unknown counter group %s", name.c_str());
+        return;
+    }
+    CounterPollGroup &group = group_it->second;
+
+    group.objects.insert(id);
+
+    if (group.enabled && group.counterIds.empty())
+    {
+        probeCounters(name, group, m_groupStatIds[name]);
+        group.enabled = !group.counterIds.empty();
+    }
+}
+
+/*
+ * The object is unregistered before its owner removes it from the SAI, so
+ * wait for the poller thread to finish reading it if it is being read.
+ */
+void CounterPollOrch::removeObject(const string &name, sai_object_id_t id)
+{
+    SWSS_LOG_ENTER();
+
+    unique_lock<mutex> lock(m_pollMutex);
+
+    auto group_it = m_groups.find(name);
+    if (group_it == m_groups.end() || !group_it->second.registered)
+    {
+        SWSS_LOG_ERROR("Unknown counter group %s", name.c_str());
+        return;
+    }
+    CounterPollGroup &group = group_it->second;
+
+    group.objects.erase(id);
+    group.samples.erase(id);
+
+    m_pollDone.wait(lock, [&] { return m_inFlight.find(id) == m_inFlight.end(); });
+
+    m_countersTable->del(sai_serialize_object_id(id));
+}
+
+void CounterPollOrch::addPortObjects(CounterPollGroup &group)
+{
+    /* Port names are published to COUNTERS_PORT_NAME_MAP by PortsOrch */
+    for (const auto &it : gPortsOrch->getAllPorts())
+    {
+        if (it.second.m_type == Port::PHY)
+        {
+            group.objects.insert(it.second.m_port_id);
+        }
+    }
+}
+
+void CounterPollOrch::addQueueObjects(CounterPollGroup &group)
+{
+    vector<FieldValueTuple> queueNames;
+
+    for (const auto &it : gPortsOrch->getAllPorts())
+    {
+        const Port &port = it.second;
+        if (port.m_type != Port::PHY)
+        {
+            continue;
+        }
+
+        for (size_t ind = 0; ind < port.m_queue_ids.size(); ind++)
+        {
+            group.objects.insert(port.m_queue_ids[ind]);
+            queueNames.emplace_back(port.m_alias + delimiter + to_string(ind), sai_serialize_object_id(port.m_queue_ids[ind]));
+        }
+    }
+
+    m_queueNameMapTable->set("", queueNames);
+}
+
+void CounterPollOrch::addPgObjects(CounterPollGroup &group)
+{
+    vector<FieldValueTuple> pgNames;
+
+    for (const auto &it : gPortsOrch->getAllPorts())
+    {
+        const Port &port = it.second;
+        if (port.m_type != Port::PHY)
+        {
+            continue;
+        }
+
+        for (size_t ind = 0; ind < port.m_priority_group_ids.size(); ind++)
+        {
+            group.objects.insert(port.m_priority_group_ids[ind]);
+            pgNames.emplace_back(port.m_alias + delimiter + to_string(ind), sai_serialize_object_id(port.m_priority_group_ids[ind]));
+        }
+    }
+
+    m_pgNameMapTable->set("", pgNames);
+}
+
+/*
+ * A stats call fails as a whole when one of the counters is not supported,
+ * so keep only the counters the first object of the group can be read with.
+ */
+template <typename stat_t>
+void CounterPollOrch::probeCounters(const string &name, CounterPollGroup &group, const vector<pair<stat_t, string>> &statIds)
+{
+    SWSS_LOG_ENTER();
+
+    group.counterIds.clear();
+    group.counterNames.clear();
+
+    if (group.objects.empty())
+    {
+        return;
+    }
+
+    for (const auto &it : statIds)
+    {
+        int32_t counterId = it.first;
+        uint64_t counter;
+        if (group.getStats(*group.objects.begin(), 1, &counterId, &counter) != SAI_STATUS_SUCCESS)
+        {
+            SWSS_LOG_INFO("Counter %s is not supported", it.second.c_str());
+            continue;
+        }
+        group.counterIds.push_back(counterId);
+        group.counterNames.push_back(it.second);
+    }
+
+    if (group.counterIds.empty())
+    {
+        SWSS_LOG_ERROR("No supported counters found for counter group %s", name.c_str());
+    }
+    else if (group.counterIds.size() < statIds.size())
+    {
+        SWSS_LOG_NOTICE("Counter group %s supports %zu of %zu counters", name.c_str(),
+                        group.counterIds.size(), statIds.size());
+    }
+}
+
+/*
+ * Poll every enabled group when its interval expires. The time the thread
+ * spends polling is kept within COUNTER_POLL_CPU_BUDGET percent: after a
+ * pass that took T, no group is polled again before T * (100 - budget) /
+ * budget has passed, even if its interval is shorter.
+ */
+void CounterPollOrch::pollCountersThread()
+{
+    SWSS_LOG_ENTER();
+
+    DBConnector db(COUNTERS_DB, DBConnector::DEFAULT_UNIXSOCKET, 0);
+    RedisPipeline pipeline(&db);
+    Table countersTable(&pipeline, COUNTERS_TABLE, true);
+
+    auto earliestPoll = chrono::steady_clock::now();
+
+    unique_lock<mutex> lock(m_pollMutex);
+
+    while (m_pollCounters)
+    {
+        bool pending = false;
+        auto nextPoll = chrono::steady_clock::time_point::max();
+
+        for (auto &it : m_groups)
+        {
+            CounterPollGroup &group = it.second;
+            if (!group.enabled)
+            {
+                continue;
+            }
+
+            auto now = chrono::steady_clock::now();
+            if (group.nextPoll <= now && earliestPoll <= now)
+            {
+                pollGroup(it.first, group, pipeline, countersTable, lock);
+
+                auto pollEnd = chrono::steady_clock::now();
+                auto busy = pollEnd - now;
+                earliestPoll = pollEnd + busy * (100 - COUNTER_POLL_CPU_BUDGET) / COUNTER_POLL_CPU_BUDGET;
+                group.nextPoll = now + group.interval;
+
+                if (group.nextPoll < earliestPoll)
+                {
+                    SWSS_LOG_WARN("Counter group %s polling time exceeds its CPU budget, interval is stretched", it.first.c_str());
+                }
+            }
+
+            if (group.enabled)
+            {
+                pending = true;
+                nextPoll = min(nextPoll, max(group.nextPoll, earliestPoll));
+            }
+        }
+
+        if (!m_pollCounters)
+        {
+            break;
+        }
+
+        if (pending)
+        {
+            m_sleepGuard.wait_until(lock, nextPoll);
+        }
+        else
+        {
+            m_sleepGuard.wait(lock);
+        }
+    }
+}
+
+/*
+ * Read the group in batches of COUNTER_POLL_BATCH_SIZE objects. The SAI calls
+ * of a batch are made without holding m_pollMutex, so the main thread is only
+ * blocked when it removes an object that is being read. Objects removed while
+ * their batch was read are not written back to COUNTERS_DB.
+ */
+void CounterPollOrch::pollGroup(const string &name, CounterPollGroup &group, RedisPipeline &pipeline, Table &countersTable, unique_lock<mutex> &lock)
+{
+    vector<sai_object_id_t> objects(group.objects.begin(), group.objects.end());
+    vector<int32_t> counterIds = group.counterIds;
+    vector<string> counterNames = group.counterNames;
+    counter_poll_get_stats_t getStats = group.getStats;
+
+    size_t cursor = 0;
+    while (m_pollCounters && group.enabled && cursor < objects.size())
+    {
+        size_t end = min(cursor + COUNTER_POLL_BATCH_SIZE, objects.size());
+        m_inFlight.insert(objects.begin() + cursor, objects.begin() + end);
+        lock.unlock();
+
+        map<sai_object_id_t, vector<uint64_t>> values;
+        sai_status_t failure = SAI_STATUS_SUCCESS;
+        for (; cursor < end; cursor++)
+        {
+            sai_object_id_t id = objects[cursor];
+            vector<uint64_t> counters(counterIds.size());
+
+            sai_status_t status = getStats(id, (uint32_t)counterIds.size(), counterIds.data(), counters.data());
+            if (status != SAI_STATUS_SUCCESS)
+            {
+                SWSS_LOG_DEBUG("Failed to get stats of 0x%lx, rv:%d", id, status);
+                failure = status;
+                continue;
+            }
+            values[id] = counters;
+        }
+        auto now = chrono::steady_clock::now();
+
+        lock.lock();
+        m_inFlight.clear();
+        m_pollDone.notify_all();
+
+        if (failure != SAI_STATUS_SUCCESS && !group.failureLogged)
+        {
+            SWSS_LOG_NOTICE("Failed to get stats of counter group %s, rv:%d", name.c_str(), failure);
+            group.failureLogged = true;
+        }
+
+        for (const auto &it : values)
+        {
+            if (group.objects.find(it.first) == group.objects.end())
+            {
+                continue;
+            }
+
+            const vector<uint64_t> &counters = it.second;
+            vector<FieldValueTuple> fieldValues;
+            for (size_t j = 0; j < counterIds.size(); j++)
+            {
+                fieldValues.emplace_back(counterNames[j], to_string(counters[j]));
+            }
+
+            if (group.rates)
+            {
+                /* Rates need a previous sample of the same counters */
+                auto sample = group.samples.find(it.first);
+                if (sample != group.samples.end() && sample->second.counters.size() == counters.size())
+                {
+                    chrono::duration<double> elapsed = now - sample->second.time;
+                    for (size_t j = 0; j < counterIds.size() && elapsed.count() > 0; j++)
+                    {
+                        uint64_t prev = sample->second.counters[j];
+                        uint64_t delta = counters[j] >= prev ? counters[j] - prev : 0;
+                        fieldValues.emplace_back(counterNames[j] + "_RATE",
+                                to_string((uint64_t)((double)delta / elapsed.count())));
+                    }
+                }
+                group.samples[it.first] = { now, counters };
+            }
+
+            countersTable.set(sai_serialize_object_id(it.first), fieldValues);
+        }
+
+        /* Flush before a removed object could be deleted from COUNTERS_DB */
+        pipeline.flush();
+    }
+}
@@ -0,0 +1,131 @@
+#ifndef SWSS_COUNTERPOLLORCH_H
+#define SWSS_COUNTERPOLLORCH_H
+
+#include "orch.h"
+#include "portsorch.h"
+#include "redispipeline.h"
+
+#include <map>
+#include <set>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#define APP_COUNTER_POLL_TABLE_NAME     "COUNTER_POLL_TABLE"
+
+#define COUNTERS_QUEUE_NAME_MAP         "COUNTERS_QUEUE_NAME_MAP"
+#define COUNTERS_PG_NAME_MAP            "COUNTERS_PG_NAME_MAP"
+
+#define COUNTER_POLL_GROUP_PORT         "PORT"
+#define COUNTER_POLL_GROUP_QUEUE        "QUEUE"
+#define COUNTER_POLL_GROUP_PG           "PG"
+#define COUNTER_POLL_GROUP_RIF          "RIF"
+#define COUNTER_POLL_GROUP_COPP         "COPP"
+
+/* Number of objects read between two checks of the configuration and the CPU budget */
+#define COUNTER_POLL_BATCH_SIZE         128
+/* Default polling interval of a counter group in milliseconds */
+#define COUNTER_POLL_DEFAULT_INTERVAL   1000
+/* Share of wall time in percent the poller thread may spend reading counters */
+#define COUNTER_POLL_CPU_BUDGET         20
+
+const string counter_poll_interval_field_name   = "poll_interval";
+const string counter_poll_status_field_name     = "status";
+const string counter_poll_status_enable         = "enable";
+const string counter_poll_status_disable        = "disable";
+
+typedef sai_status_t (*counter_poll_get_stats_t)(sai_object_id_t, uint32_t, const int32_t *, uint64_t *);
+
+/* Counters of an object read in the previous pass, used to compute rates */
+struct CounterPollSample
+{
+    chrono::steady_clock::time_point time;
+    vector<uint64_t> counters;
+};
+
+struct CounterPollGroup
+{
+    bool enabled = false;
+    chrono::milliseconds interval = chrono::milliseconds(COUNTER_POLL_DEFAULT_INTERVAL);
+    chrono::steady_clock::time_point nextPoll;
+
+    counter_poll_get_stats_t getStats;
+    /* Counters supported by the platform, probed when the group is enabled */
+    vector<int32_t> counterIds;
+    vector<string> counterNames;
+    /* Polled objects, registered by their owner when the group is not discovered on enable */
+    set<sai_object_id_t> objects;
+    bool registered = false;
+    /* Publish "<counter>_RATE" per second rates next to the counters */
+    bool rates = false;
+    map<sai_object_id_t, CounterPollSample> samples;
+    bool failureLogged = false;
+};
+
+/*
+ * Polls port, queue, priority group, router interface and CoPP policer
+ * counters on its own thread and writes them to COUNTERS_DB. Every group has its own interval and
+ * is configured through COUNTER_POLL_TABLE, e.g. "COUNTER_POLL_TABLE:QUEUE"
+ * poll_interval=1000 status=enable. Other orchs register the objects of
+ * their groups with addObject() and removeObject().
+ */
+class CounterPollOrch : public Orch
+{
+public:
+    CounterPollOrch(DBConnector *db, string tableName);
+    ~CounterPollOrch();
+
+    template <typename stat_t>
+    void addGroup(const string &name, counter_poll_get_stats_t getStats,
+                  const vector<pair<stat_t, string>> &statIds, bool rates)
+    {
+        unique_lock<mutex> lock(m_pollMutex);
+
+        CounterPollGroup &group = m_groups[name];
+        group.getStats = getStats;
+        group.registered = true;
+        group.rates = rates;
+
+        m_groupStatIds[name].clear();
+        for (const auto &it : statIds)
+        {
+            m_groupStatIds[name].emplace_back(it.first, it.second);
+        }
+    }
+    void addObject(const string &name, sai_object_id_t id);
+    void removeObject(const string &name, sai_object_id_t id);
+
+private:
+    void doTask(Consumer &consumer);
+
+    bool enableGroup(const string &name, CounterPollGroup &group);
+    void addPortObjects(CounterPollGroup &group);
+    void addQueueObjects(CounterPollGroup &group);
+    void addPgObjects(CounterPollGroup &group);
+    template <typename stat_t>
+    void probeCounters(const string &name, CounterPollGroup &group, const vector<pair<stat_t, string>> &statIds);
+
+    void pollCountersThread();
+    void pollGroup(const string &name, CounterPollGroup &group, RedisPipeline &pipeline, Table &countersTable, unique_lock<mutex> &lock);
+
+    unique_ptr<DBConnector> m_countersDb;
+    unique_ptr<Table> m_countersTable;
+    unique_ptr<Table> m_queueNameMapTable;
+    unique_ptr<Table> m_pgNameMapTable;
+
+    map<string, CounterPollGroup> m_groups;
+    /* Counter names of the registered groups */
+    map<string, vector<pair<int32_t, string>>> m_groupStatIds;
+
+    mutex m_pollMutex;
+    condition_variable m_sleepGuard;
+    bool m_pollCounters = true;
+    thread m_pollThread;
+
+    /* Objects read by the poller thread without holding m_pollMutex */
+    set<sai_object_id_t> m_inFlight;
+    condition_variable m_pollDone;
+};
+
+#endif /* SWSS_COUNTERPOLLORCH_H */
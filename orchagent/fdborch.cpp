@@ -89,8 +89,8 @@ void FdbOrch::doTask(Consumer& consumer)
         vector<string> keys = tokenize(kfvKey(t), ':', 1);
         string op = kfvOp(t);
 
-        Port vlan;
-        if (!m_portsOrch->getPort(keys[0], vlan))
+        Port *vlan = m_portsOrch->findPort(keys[0]);
+        if (!vlan)
         {
             SWSS_LOG_INFO("Failed to locate %s", keys[0].c_str());
             it++;
@@ -99,7 +99,7 @@ void FdbOrch::doTask(Consumer& consumer)
 
         FdbEntry entry;
         entry.mac = MacAddress(keys[1]);
-        entry.vlan = vlan.m_vlan_id;
+        entry.vlan = vlan->m_vlan_id;
 
         if (op == SET_COMMAND)
         {
@@ -171,16 +171,16 @@ bool FdbOrch::addFdbEntry(const FdbEntry& entry, const string& port_name, const
     fdb_entry.vlan_id = entry.vlan;
     fdb_entry.bridge_id = SAI_NULL_OBJECT_ID;
 
-    Port port;
     /* Retry until port is created */
-    if (!m_portsOrch->getPort(port_name, port))
+    Port *port = m_portsOrch->findPort(port_name);
+    if (!port)
     {
         SWSS_LOG_INFO("Failed to locate port %s", port_name.c_str());
         return false;
     }
 
     /* Retry until port is added to the VLAN */
-    if (!port.m_bridge_port_id)
+    if (!port->m_bridge_port_id)
     {
         SWSS_LOG_INFO("Port %s does not have a bridge port ID", port_name.c_str());
         return false;
@@ -194,7 +194,7 @@ bool FdbOrch::addFdbEntry(const FdbEntry& entry, const string& port_name, const
     attrs.push_back(attr);
 
     attr.id = SAI_FDB_ENTRY_ATTR_BRIDGE_PORT_ID;
-    attr.value.oid = port.m_bridge_port_id;
+    attr.value.oid = port->m_bridge_port_id;
     attrs.push_back(attr);
 
     attr.id = SAI_FDB_ENTRY_ATTR_PACKET_ACTION;
@@ -5,31 +5,57 @@
 #include <net/if.h>
 
 #include "intfsorch.h"
+#include "routeorch.h"
+#include "counterpollorch.h"
 #include "ipprefix.h"
 #include "logger.h"
 #include "swssnet.h"
 #include "tokenize.h"
+#include "saiserialize.h"
 
 extern sai_object_id_t gVirtualRouterId;
 
 extern sai_router_interface_api_t*  sai_router_intfs_api;
-extern sai_route_api_t*             sai_route_api;
 
 extern PortsOrch *gPortsOrch;
+extern RouteOrch *gRouteOrch;
+extern CounterPollOrch *gCounterPollOrch;
 extern sai_object_id_t gSwitchId;
 
+static const vector<pair<sai_router_interface_stat_t, string>> rifStatIds =
+{
+    { SAI_ROUTER_INTERFACE_STAT_IN_OCTETS,          "SAI_ROUTER_INTERFACE_STAT_IN_OCTETS" },
+    { SAI_ROUTER_INTERFACE_STAT_IN_PACKETS,         "SAI_ROUTER_INTERFACE_STAT_IN_PACKETS" },
+    { SAI_ROUTER_INTERFACE_STAT_OUT_OCTETS,         "SAI_ROUTER_INTERFACE_STAT_OUT_OCTETS" },
+    { SAI_ROUTER_INTERFACE_STAT_OUT_PACKETS,        "SAI_ROUTER_INTERFACE_STAT_OUT_PACKETS" },
+    { SAI_ROUTER_INTERFACE_STAT_IN_ERROR_OCTETS,    "SAI_ROUTER_INTERFACE_STAT_IN_ERROR_OCTETS" },
+    { SAI_ROUTER_INTERFACE_STAT_IN_ERROR_PACKETS,   "SAI_ROUTER_INTERFACE_STAT_IN_ERROR_PACKETS" },
+    { SAI_ROUTER_INTERFACE_STAT_OUT_ERROR_OCTETS,   "SAI_ROUTER_INTERFACE_STAT_OUT_ERROR_OCTETS" },
+    { SAI_ROUTER_INTERFACE_STAT_OUT_ERROR_PACKETS,  "SAI_ROUTER_INTERFACE_STAT_OUT_ERROR_PACKETS" },
+};
+
+static sai_status_t getRifStats(sai_object_id_t id, uint32_t count, const int32_t *counterIds, uint64_t *counters)
+{
+    return sai_router_intfs_api->get_router_interface_stats(id, count,
+            reinterpret_cast<const sai_router_interface_stat_t *>(counterIds), counters);
+}
+
 IntfsOrch::IntfsOrch(DBConnector *db, string tableName) :
         Orch(db, tableName)
 {
     SWSS_LOG_ENTER();
+
+    m_countersDb = unique_ptr<DBConnector>(new DBConnector(COUNTERS_DB, DBConnector::DEFAULT_UNIXSOCKET, 0));
+    m_rifNameMapTable = unique_ptr<Table>(new Table(m_countersDb.get(), COUNTERS_RIF_NAME_MAP));
+
+    gCounterPollOrch->addGroup(COUNTER_POLL_GROUP_RIF, getRifStats, rifStatIds, false);
 }
 
 sai_object_id_t IntfsOrch::getRouterIntfsId(const string &alias)
 {
-    Port port;
-    gPortsOrch->getPort(alias, port);
-    assert(port.m_rif_id);
-    return port.m_rif_id;
+    Port *port = gPortsOrch->findPort(alias);
+    assert(port && port->m_rif_id);
+    return port->m_rif_id;
 }
 
 void IntfsOrch::increaseRouterIntfsRefCount(const string &alias)
@@ -57,7 +83,7 @@ void IntfsOrch::doTask(Consumer &consumer)
     auto it = consumer.m_toSync.begin();
     while (it != consumer.m_toSync.end())
     {
-        KeyOpFieldsValuesTuple t = it->second;
+        auto &t = it->second;
 
         vector<string> keys = tokenize(kfvKey(t), ':');
         string alias(keys[0]);
@@ -74,13 +100,15 @@ void IntfsOrch::doTask(Consumer &consumer)
         {
             if (alias == "lo")
             {
-                addIp2MeRoute(ip_prefix);
-                it = consumer.m_toSync.erase(it);
+                if (addIp2MeRoute(ip_prefix))
+                    it = consumer.m_toSync.erase(it);
+                else
+                    it++;
                 continue;
             }
 
-            Port port;
-            if (!gPortsOrch->getPort(alias, port))
+            Port *port = gPortsOrch->findPort(alias);
+            if (!port)
             {
                 /* TODO: Resolve the dependency relationship and add ref_count to port */
                 it++;
@@ -90,7 +118,7 @@ void IntfsOrch::doTask(Consumer &consumer)
             auto it_intfs = m_syncdIntfses.find(alias);
             if (it_intfs == m_syncdIntfses.end())
             {
-                if (addRouterIntfs(port))
+                if (addRouterIntfs(*port))
                 {
                     IntfsEntry intfs_entry;
                     intfs_entry.ref_count = 0;
@@ -125,7 +153,7 @@ void IntfsOrch::doTask(Consumer &consumer)
                         ip_prefix.isAddressInSubnet(prefixIt.getIp()))
                 {
                     overlaps = true;
-                    SWSS_LOG_NOTICE("Router interface %s IP %s overlaps with %s.", port.m_alias.c_str(),
+                    SWSS_LOG_NOTICE("Router interface %s IP %s overlaps with %s.", port->m_alias.c_str(),
                             prefixIt.to_string().c_str(), ip_prefix.to_string().c_str());
                     break;
                 }
@@ -138,8 +166,29 @@ void IntfsOrch::doTask(Consumer &consumer)
                 continue;
             }
 
-            addSubnetRoute(port, ip_prefix);
-            addIp2MeRoute(ip_prefix);
+            /* The prefixes are taken by other interface routes, wait for their removal */
+            if ((!isHostPrefix(ip_prefix) &&
+                 gRouteOrch->hasIntfRouteConflict(ip_prefix.getSubnet(), true)) ||
+                gRouteOrch->hasIntfRouteConflict(IpPrefix(ip_prefix.getIp().to_string()), false))
+            {
+                SWSS_LOG_INFO("Interface routes of %s conflict with existing routes",
+                              ip_prefix.to_string().c_str());
+                it++;
+                continue;
+            }
+
+            if (!addSubnetRoute(*port, ip_prefix))
+            {
+                it++;
+                continue;
+            }
+
+            if (!addIp2MeRoute(ip_prefix))
+            {
+                removeSubnetRoute(*port, ip_prefix);
+                it++;
+                continue;
+            }
 
             m_syncdIntfses[alias].ip_addresses.insert(ip_prefix);
             it = consumer.m_toSync.erase(it);
@@ -153,9 +202,9 @@ void IntfsOrch::doTask(Consumer &consumer)
                 continue;
             }
 
-            Port port;
             /* Cannot locate interface */
-            if (!gPortsOrch->getPort(alias, port))
+            Port *port = gPortsOrch->findPort(alias);
+            if (!port)
             {
                 it = consumer.m_toSync.erase(it);
                 continue;
@@ -165,7 +214,7 @@ void IntfsOrch::doTask(Consumer &consumer)
             {
                 if (m_syncdIntfses[alias].ip_addresses.count(ip_prefix))
                 {
-                    removeSubnetRoute(port, ip_prefix);
+                    removeSubnetRoute(*port, ip_prefix);
                     removeIp2MeRoute(ip_prefix);
 
                     m_syncdIntfses[alias].ip_addresses.erase(ip_prefix);
@@ -174,7 +223,10 @@ void IntfsOrch::doTask(Consumer &consumer)
                 /* Remove router interface that no IP addresses are associated with */
                 if (m_syncdIntfses[alias].ip_addresses.size() == 0)
                 {
-                    if (removeRouterIntfs(port))
+                    /* Subnet routes must leave the ASIC before the router interface */
+                    gRouteOrch->flushIntfRoutes();
+
+                    if (removeRouterIntfs(*port))
                     {
                         m_syncdIntfses.erase(alias);
                         it = consumer.m_toSync.erase(it);
@@ -192,6 +244,9 @@ void IntfsOrch::doTask(Consumer &consumer)
                 it = consumer.m_toSync.erase(it);
         }
     }
+
+    /* Program all subnet and ip2me routes queued in this batch */
+    gRouteOrch->flushIntfRoutes();
 }
 
 bool IntfsOrch::addRouterIntfs(Port &port)
@@ -261,7 +316,7 @@ bool IntfsOrch::addRouterIntfs(Port &port)
         throw runtime_error("Failed to create router interface.");
     }
 
-    gPortsOrch->setPort(port.m_alias, port);
+    addRifCounters(port);
 
     SWSS_LOG_NOTICE("Create router interface for port %s", port.m_alias.c_str());
 
@@ -278,6 +333,8 @@ bool IntfsOrch::removeRouterIntfs(Port &port)
         return false;
     }
 
+    removeRifCounters(port);
+
     sai_status_t status = sai_router_intfs_api->remove_router_interface(port.m_rif_id);
     if (status != SAI_STATUS_SUCCESS)
     {
@@ -286,110 +343,93 @@ bool IntfsOrch::removeRouterIntfs(Port &port)
     }
 
     port.m_rif_id = 0;
-    gPortsOrch->setPort(port.m_alias, port);
 
     SWSS_LOG_NOTICE("Remove router interface for port %s", port.m_alias.c_str());
 
     return true;
 }
 
-void IntfsOrch::addSubnetRoute(const Port &port, const IpPrefix &ip_prefix)
+void IntfsOrch::addRifCounters(const Port &port)
 {
-    sai_route_entry_t unicast_route_entry;
-    unicast_route_entry.switch_id = gSwitchId;
-    unicast_route_entry.vr_id = gVirtualRouterId;
-    copy(unicast_route_entry.destination, ip_prefix);
-    subnet(unicast_route_entry.destination, unicast_route_entry.destination);
+    SWSS_LOG_ENTER();
 
-    sai_attribute_t attr;
-    vector<sai_attribute_t> attrs;
+    vector<FieldValueTuple> fieldValues;
+    fieldValues.emplace_back(port.m_alias, sai_serialize_object_id(port.m_rif_id));
+    m_rifNameMapTable->set("", fieldValues);
 
-    attr.id = SAI_ROUTE_ENTRY_ATTR_PACKET_ACTION;
-    attr.value.s32 = SAI_PACKET_ACTION_FORWARD;
-    attrs.push_back(attr);
+    gCounterPollOrch->addObject(COUNTER_POLL_GROUP_RIF, port.m_rif_id);
+}
 
-    attr.id = SAI_ROUTE_ENTRY_ATTR_NEXT_HOP_ID;
-    attr.value.oid = port.m_rif_id;
-    attrs.push_back(attr);
+void IntfsOrch::removeRifCounters(const Port &port)
+{
+    SWSS_LOG_ENTER();
 
-    sai_status_t status = sai_route_api->create_route_entry(&unicast_route_entry, (uint32_t)attrs.size(), attrs.data());
-    if (status != SAI_STATUS_SUCCESS)
+    gCounterPollOrch->removeObject(COUNTER_POLL_GROUP_RIF, port.m_rif_id);
+
+    m_rifNameMapTable->hdel("", port.m_alias);
+}
+
+bool IntfsOrch::isHostPrefix(const IpPrefix &ip_prefix) const
+{
+    return ip_prefix.getMaskLength() == (ip_prefix.isV4() ? 32 : 128);
+}
+
+bool IntfsOrch::addSubnetRoute(const Port &port, const IpPrefix &ip_prefix)
+{
+    SWSS_LOG_ENTER();
+
+    /* A host address has no subnet, its ip2me route is the only route */
+    if (!isHostPrefix(ip_prefix))
     {
-        SWSS_LOG_ERROR("Failed to create subnet route to %s from %s, rv:%d",
-                       ip_prefix.to_string().c_str(), port.m_alias.c_str(), status);
-        throw runtime_error("Failed to create subnet route.");
-    }
+        if (!gRouteOrch->addIntfRoute(ip_prefix.getSubnet(), port.m_rif_id, true))
+        {
+            return false;
+        }
 
-    SWSS_LOG_NOTICE("Create subnet route to %s from %s",
-                    ip_prefix.to_string().c_str(), port.m_alias.c_str());
+        SWSS_LOG_INFO("Queue subnet route to %s from %s",
+                      ip_prefix.getSubnet().to_string().c_str(), port.m_alias.c_str());
+    }
     increaseRouterIntfsRefCount(port.m_alias);
+
+    return true;
 }
 
 void IntfsOrch::removeSubnetRoute(const Port &port, const IpPrefix &ip_prefix)
 {
-    sai_route_entry_t unicast_route_entry;
-    unicast_route_entry.switch_id = gSwitchId;
-    unicast_route_entry.vr_id = gVirtualRouterId;
-    copy(unicast_route_entry.destination, ip_prefix);
-    subnet(unicast_route_entry.destination, unicast_route_entry.destination);
+    SWSS_LOG_ENTER();
 
-    sai_status_t status = sai_route_api->remove_route_entry(&unicast_route_entry);
-    if (status != SAI_STATUS_SUCCESS)
+    if (!isHostPrefix(ip_prefix))
     {
-        SWSS_LOG_ERROR("Failed to remove subnet route to %s from %s, rv:%d",
-                       ip_prefix.to_string().c_str(), port.m_alias.c_str(), status);
-        throw runtime_error("Failed to remove subnet route.");
-    }
+        gRouteOrch->removeIntfRoute(ip_prefix.getSubnet());
 
-    SWSS_LOG_NOTICE("Remove subnet route to %s from %s",
-                    ip_prefix.to_string().c_str(), port.m_alias.c_str());
+        SWSS_LOG_INFO("Queue removal of subnet route to %s from %s",
+                      ip_prefix.getSubnet().to_string().c_str(), port.m_alias.c_str());
+    }
     decreaseRouterIntfsRefCount(port.m_alias);
 }
 
-void IntfsOrch::addIp2MeRoute(const IpPrefix &ip_prefix)
+bool IntfsOrch::addIp2MeRoute(const IpPrefix &ip_prefix)
 {
-    sai_route_entry_t unicast_route_entry;
-    unicast_route_entry.switch_id = gSwitchId;
-    unicast_route_entry.vr_id = gVirtualRouterId;
-    copy(unicast_route_entry.destination, ip_prefix.getIp());
-
-    sai_attribute_t attr;
-    vector<sai_attribute_t> attrs;
-
-    attr.id = SAI_ROUTE_ENTRY_ATTR_PACKET_ACTION;
-    attr.value.s32 = SAI_PACKET_ACTION_FORWARD;
-    attrs.push_back(attr);
+    SWSS_LOG_ENTER();
 
     Port cpu_port;
     gPortsOrch->getCpuPort(cpu_port);
 
-    attr.id = SAI_ROUTE_ENTRY_ATTR_NEXT_HOP_ID;
-    attr.value.oid = cpu_port.m_port_id;
-    attrs.push_back(attr);
-
-    sai_status_t status = sai_route_api->create_route_entry(&unicast_route_entry, (uint32_t)attrs.size(), attrs.data());
-    if (status != SAI_STATUS_SUCCESS)
+    if (!gRouteOrch->addIntfRoute(IpPrefix(ip_prefix.getIp().to_string()), cpu_port.m_port_id, false))
     {
-        SWSS_LOG_ERROR("Failed to create IP2me route ip:%s, rv:%d", ip_prefix.getIp().to_string().c_str(), status);
-        throw runtime_error("Failed to create IP2me route.");
+        return false;
     }
 
-    SWSS_LOG_NOTICE("Create IP2me route ip:%s", ip_prefix.getIp().to_string().c_str());
+    SWSS_LOG_INFO("Queue IP2me route ip:%s", ip_prefix.getIp().to_string().c_str());
+
+    return true;
 }
 
 void IntfsOrch::removeIp2MeRoute(const IpPrefix &ip_prefix)
 {
-    sai_route_entry_t unicast_route_entry;
-    unicast_route_entry.switch_id = gSwitchId;
-    unicast_route_entry.vr_id = gVirtualRouterId;
-    copy(unicast_route_entry.destination, ip_prefix.getIp());
+    SWSS_LOG_ENTER();
 
-    sai_status_t status = sai_route_api->remove_route_entry(&unicast_route_entry);
-    if (status != SAI_STATUS_SUCCESS)
-    {
-        SWSS_LOG_ERROR("Failed to remove IP2me route ip:%s, rv:%d", ip_prefix.getIp().to_string().c_str(), status);
-        throw runtime_error("Failed to remove IP2me route.");
-    }
+    gRouteOrch->removeIntfRoute(IpPrefix(ip_prefix.getIp().to_string()));
 
-    SWSS_LOG_NOTICE("Remove packet action trap route ip:%s", ip_prefix.getIp().to_string().c_str());
+    SWSS_LOG_INFO("Queue removal of IP2me route ip:%s", ip_prefix.getIp().to_string().c_str());
 }
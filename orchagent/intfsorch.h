@@ -11,6 +11,8 @@
 #include <map>
 #include <set>
 
+#define COUNTERS_RIF_NAME_MAP   "COUNTERS_RIF_NAME_MAP"
+
 extern sai_object_id_t gVirtualRouterId;
 extern MacAddress gMacAddress;
 
@@ -35,15 +37,22 @@ private:
     IntfsTable m_syncdIntfses;
     void doTask(Consumer &consumer);
 
+    unique_ptr<DBConnector> m_countersDb;
+    unique_ptr<Table> m_rifNameMapTable;
+
+    void addRifCounters(const Port &port);
+    void removeRifCounters(const Port &port);
+
     int getRouterIntfsRefCount(const string&);
 
     bool addRouterIntfs(Port &port);
     bool removeRouterIntfs(Port &port);
 
-    void addSubnetRoute(const Port &port, const IpPrefix &ip_prefix);
+    bool isHostPrefix(const IpPrefix &ip_prefix) const;
+    bool addSubnetRoute(const Port &port, const IpPrefix &ip_prefix);
     void removeSubnetRoute(const Port &port, const IpPrefix &ip_prefix);
 
-    void addIp2MeRoute(const IpPrefix &ip_prefix);
+    bool addIp2MeRoute(const IpPrefix &ip_prefix);
     void removeIp2MeRoute(const IpPrefix &ip_prefix);
 };
 
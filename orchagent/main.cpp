@@ -37,6 +37,14 @@ MacAddress gMacAddress;
 #define DEFAULT_BATCH_SIZE  128
 int gBatchSize = DEFAULT_BATCH_SIZE;
 
+/* Buffer watermark polling interval in milliseconds, 0 disables it */
+int gWatermarkInterval = 0;
+/* Clear buffer watermarks after every read */
+bool gWatermarkClearOnRead = false;
+
+/* Use Lua scripts for PFC watchdog storm detection */
+bool gPfcWdLuaDetection = false;
+
 bool gSairedisRecord = true;
 bool gSwssRecord = true;
 bool gLogRotate = false;
@@ -48,7 +56,7 @@ mutex gDbMutex;
 
 void usage()
 {
-    cout << "usage: orchagent [-h] [-r record_type] [-d record_location] [-b batch_size] [-m MAC]" << endl;
+    cout << "usage: orchagent [-h] [-r record_type] [-d record_location] [-b batch_size] [-m MAC] [-w watermark_interval] [-c] [-l]" << endl;
     cout << "    -h: display this message" << endl;
     cout << "    -r record_type: record orchagent logs with type (default 3)" << endl;
     cout << "                    0: do not record logs" << endl;
@@ -58,6 +66,10 @@ void usage()
     cout << "    -d record_location: set record logs folder location (default .)" << endl;
     cout << "    -b batch_size: set consumer table pop operation batch size (default 128)" << endl;
     cout << "    -m MAC: set switch MAC address" << endl;
+    cout << "    -w watermark_interval: set buffer watermark polling interval in milliseconds," << endl;
+    cout << "                           0 disables the collection (default 0)" << endl;
+    cout << "    -c: clear buffer watermarks on every read" << endl;
+    cout << "    -l: detect PFC storms with Lua scripts (compatibility mode)" << endl;
 }
 
 void sighup_handler(int signo)
@@ -94,7 +106,7 @@ int main(int argc, char **argv)
 
     string record_location = ".";
 
-    while ((opt = getopt(argc, argv, "b:m:r:d:h")) != -1)
+    while ((opt = getopt(argc, argv, "b:m:r:d:w:clh")) != -1)
     {
         switch (opt)
         {
@@ -104,6 +116,15 @@ int main(int argc, char **argv)
         case 'm':
             gMacAddress = MacAddress(optarg);
             break;
+        case 'w':
+            gWatermarkInterval = atoi(optarg);
+            break;
+        case 'c':
+            gWatermarkClearOnRead = true;
+            break;
+        case 'l':
+            gPfcWdLuaDetection = true;
+            break;
         case 'r':
             if (!strcmp(optarg, "0"))
             {
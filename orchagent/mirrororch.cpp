@@ -7,6 +7,7 @@
 #include "swssnet.h"
 #include "converter.h"
 #include "mirrororch.h"
+#include "copporch.h"
 
 #define MIRROR_SESSION_STATUS           "status"
 #define MIRROR_SESSION_STATUS_ACTIVE    "active"
@@ -26,10 +27,27 @@
 #define MIRROR_SESSION_DSCP_MAX         63
 
 extern sai_mirror_api_t *sai_mirror_api;
+extern sai_policer_api_t *sai_policer_api;
 extern sai_object_id_t gSwitchId;
 
 using namespace std::rel_ops;
 
+template <typename K>
+static void removeFromIndex(map<K, set<string>>& index, const K& key, const string& name)
+{
+    auto it = index.find(key);
+    if (it == index.end())
+    {
+        return;
+    }
+
+    it->second.erase(name);
+    if (it->second.empty())
+    {
+        index.erase(it);
+    }
+}
+
 MirrorOrch::MirrorOrch(DBConnector *db, string tableName,
         PortsOrch *portOrch, RouteOrch *routeOrch, NeighOrch *neighOrch, FdbOrch *fdbOrch) :
         Orch(db, tableName),
@@ -37,7 +55,8 @@ MirrorOrch::MirrorOrch(DBConnector *db, string tableName,
         m_routeOrch(routeOrch),
         m_neighOrch(neighOrch),
         m_fdbOrch(fdbOrch),
-        m_mirrorTableProducer(db, tableName)
+        m_mirrorTablePipeline(db),
+        m_mirrorTableProducer(&m_mirrorTablePipeline, tableName, true)
 {
     m_portsOrch->attach(this);
     m_neighOrch->attach(this);
@@ -163,6 +182,7 @@ void MirrorOrch::createEntry(const string& key, const vector<FieldValueTuple>& d
     SWSS_LOG_ENTER();
 
     MirrorEntry entry = { };
+    sai_attribute_t attr;
 
     for (auto i : data)
     {
@@ -207,6 +227,10 @@ void MirrorOrch::createEntry(const string& key, const vector<FieldValueTuple>& d
                 // not be changed by users. Ignore it.
                 return;
             }
+            else if (parsePolicerAttribute(fvField(i), fvValue(i), attr))
+            {
+                entry.policerAttrs.push_back(attr);
+            }
             else
             {
                 SWSS_LOG_ERROR("Failed to parse session %s configuration. Unknown attribute %s.\n", key.c_str(), fvField(i).c_str());
@@ -234,7 +258,20 @@ void MirrorOrch::createEntry(const string& key, const vector<FieldValueTuple>& d
         return;
     }
 
+    /* Rate limit the mirrored traffic if any policer field is specified */
+    if (!entry.policerAttrs.empty())
+    {
+        sai_status_t status = sai_policer_api->create_policer(&entry.policerId, gSwitchId,
+                (uint32_t)entry.policerAttrs.size(), entry.policerAttrs.data());
+        if (status != SAI_STATUS_SUCCESS)
+        {
+            SWSS_LOG_ERROR("Failed to create policer for session %s, rv:%d", key.c_str(), status);
+            return;
+        }
+    }
+
     m_syncdMirrors.emplace(key, entry);
+    m_dstIpSessions[entry.dstIp].insert(key);
 
     setSessionState(key, entry);
 
@@ -268,6 +305,19 @@ void MirrorOrch::deleteEntry(const string& name)
         deactivateSession(name, session);
     }
 
+    if (session.policerId != SAI_NULL_OBJECT_ID)
+    {
+        sai_status_t status = sai_policer_api->remove_policer(session.policerId);
+        if (status != SAI_STATUS_SUCCESS)
+        {
+            SWSS_LOG_ERROR("Failed to remove policer of session %s, rv:%d", name.c_str(), status);
+        }
+    }
+
+    unindexSession(name);
+    removeFromIndex(m_dstIpSessions, session.dstIp, name);
+    m_publishedSessionStates.erase(name);
+
     m_syncdMirrors.erase(sessionIter);
 }
 
@@ -277,16 +327,56 @@ bool MirrorOrch::setSessionState(const string& name, MirrorEntry& session)
 
     SWSS_LOG_INFO("Setting mirroring sessions %s state\n", name.c_str());
 
-    vector<FieldValueTuple> fvVector;
+    // State is published by flushSessionStates() at the end of the batch
+    m_pendingSessionStates[name] = session.status;
 
-    string status = session.status ? MIRROR_SESSION_STATUS_ACTIVE : MIRROR_SESSION_STATUS_INACTIVE;
+    return true;
+}
 
-    FieldValueTuple t(MIRROR_SESSION_STATUS, status);
-    fvVector.push_back(t);
+/*
+ * Publish the final state of every session changed since the last flush
+ * with one pipelined write. Sessions that flapped back to their last
+ * published state within the batch are not written.
+ */
+void MirrorOrch::flushSessionStates()
+{
+    SWSS_LOG_ENTER();
+
+    if (m_pendingSessionStates.empty())
+    {
+        return;
+    }
 
-    m_mirrorTableProducer.set(name, fvVector);
+    for (const auto& it : m_pendingSessionStates)
+    {
+        const auto& name = it.first;
+        bool state = it.second;
 
-    return true;
+        // Session was removed within the batch
+        if (!sessionExists(name))
+        {
+            continue;
+        }
+
+        auto published = m_publishedSessionStates.find(name);
+        if (published != m_publishedSessionStates.end() && published->second == state)
+        {
+            continue;
+        }
+
+        vector<FieldValueTuple> fvVector;
+
+        string status = state ? MIRROR_SESSION_STATUS_ACTIVE : MIRROR_SESSION_STATUS_INACTIVE;
+
+        FieldValueTuple t(MIRROR_SESSION_STATUS, status);
+        fvVector.push_back(t);
+
+        m_mirrorTableProducer.set(name, fvVector);
+        m_publishedSessionStates[name] = state;
+    }
+
+    m_pendingSessionStates.clear();
+    m_mirrorTablePipeline.flush();
 }
 
 bool MirrorOrch::getNeighborInfo(const string& name, MirrorEntry& session)
@@ -350,13 +440,13 @@ bool MirrorOrch::getNeighborInfo(const string& name, MirrorEntry& session, const
         }
 
         const auto& firstMember = *session.neighborInfo.port.m_members.begin();
-        Port lagMember;
-        if (!m_portsOrch->getPort(firstMember, lagMember))
+        Port *lagMember = m_portsOrch->findPort(firstMember);
+        if (!lagMember)
         {
             throw runtime_error("Failed to get port for " + firstMember + " alias");
         }
 
-        session.neighborInfo.portId = lagMember.m_port_id;
+        session.neighborInfo.portId = lagMember->m_port_id;
         session.neighborInfo.resolved = true;
     }
     else
@@ -458,6 +548,13 @@ bool MirrorOrch::activateSession(const string& name, MirrorEntry& session)
     attr.value.u16 = session.greType;
     attrs.push_back(attr);
 
+    if (session.policerId != SAI_NULL_OBJECT_ID)
+    {
+        attr.id = SAI_MIRROR_SESSION_ATTR_POLICER;
+        attr.value.oid = session.policerId;
+        attrs.push_back(attr);
+    }
+
     session.status = true;
 
     status = sai_mirror_api->create_mirror_session(&session.sessionId, gSwitchId, (uint32_t)attrs.size(), attrs.data());
@@ -552,67 +649,138 @@ bool MirrorOrch::updateSessionDstPort(const string& name, MirrorEntry& session)
     return true;
 }
 
-void MirrorOrch::updateNextHop(const NextHopUpdate& update)
+/*
+ * Store the session in the next hop, port and FDB indexes according to its
+ * current resolution state, so that notifications only visit the sessions
+ * they may affect. Must be called after every change of the session
+ * resolution state.
+ */
+void MirrorOrch::indexSession(const string& name, const MirrorEntry& session)
 {
     SWSS_LOG_ENTER();
 
-    auto sessionIter = m_syncdMirrors.begin();
-    for (; sessionIter != m_syncdMirrors.end(); ++sessionIter)
+    unindexSession(name);
+
+    MirrorSessionIndexKeys keys = { };
+
+    if (session.nexthopInfo.resolved)
+    {
+        keys.nexthop = true;
+        keys.nexthopIp = session.nexthopInfo.nexthop;
+        m_nextHopSessions[keys.nexthopIp].insert(name);
+    }
+
+    if (session.neighborInfo.resolved)
     {
-        if (!update.prefix.isAddressInSubnet(sessionIter->second.dstIp))
+        keys.port = true;
+        keys.portAlias = session.neighborInfo.port.m_alias;
+        m_portSessions[keys.portAlias].insert(name);
+
+        if (session.neighborInfo.port.m_type == Port::VLAN)
         {
-            continue;
+            keys.fdb = true;
+            keys.fdbEntry = { session.neighborInfo.mac, session.neighborInfo.vlanId };
+            m_fdbSessions[keys.fdbEntry].insert(name);
         }
+    }
 
-        const auto& name = sessionIter->first;
-        auto& session = sessionIter->second;
+    m_sessionIndexKeys[name] = keys;
+}
 
-        SWSS_LOG_INFO("Updating mirror session %s next hop\n", name.c_str());
+void MirrorOrch::unindexSession(const string& name)
+{
+    SWSS_LOG_ENTER();
 
-        if (session.nexthopInfo.resolved)
-        {
-            // Check for ECMP route next hop update. If route prefix is the same
-            // and current next hop is still in next hop group - do nothing.
-            if (session.nexthopInfo.prefix == update.prefix && update.nexthopGroup.getIpAddresses().count(session.nexthopInfo.nexthop))
-            {
-                continue;
-            }
-        }
+    auto it = m_sessionIndexKeys.find(name);
+    if (it == m_sessionIndexKeys.end())
+    {
+        return;
+    }
+
+    const auto& keys = it->second;
+
+    if (keys.nexthop)
+    {
+        removeFromIndex(m_nextHopSessions, keys.nexthopIp, name);
+    }
+
+    if (keys.port)
+    {
+        removeFromIndex(m_portSessions, keys.portAlias, name);
+    }
+
+    if (keys.fdb)
+    {
+        removeFromIndex(m_fdbSessions, keys.fdbEntry, name);
+    }
+
+    m_sessionIndexKeys.erase(it);
+}
+
+void MirrorOrch::updateNextHop(const NextHopUpdate& update)
+{
+    SWSS_LOG_ENTER();
 
-        session.nexthopInfo.nexthop = *update.nexthopGroup.getIpAddresses().begin();
-        session.nexthopInfo.prefix = update.prefix;
-        session.nexthopInfo.resolved = true;
+    auto sessions = m_dstIpSessions.find(update.destination);
+    if (sessions == m_dstIpSessions.end())
+    {
+        return;
+    }
 
-        // Get neighbor
-        if (!getNeighborInfo(name, session))
+    // Session indexes are updated while sessions are processed
+    set<string> names = sessions->second;
+    for (const auto& name : names)
+    {
+        auto& session = m_syncdMirrors.at(name);
+
+        updateSessionNextHop(name, session, update);
+        indexSession(name, session);
+    }
+}
+
+void MirrorOrch::updateSessionNextHop(const string& name, MirrorEntry& session, const NextHopUpdate& update)
+{
+    SWSS_LOG_ENTER();
+
+    SWSS_LOG_INFO("Updating mirror session %s next hop\n", name.c_str());
+
+    if (session.nexthopInfo.resolved)
+    {
+        // Check for ECMP route next hop update. If route prefix is the same
+        // and current next hop is still in next hop group - do nothing.
+        if (session.nexthopInfo.prefix == update.prefix && update.nexthopGroup.getIpAddresses().count(session.nexthopInfo.nexthop))
         {
-            // Next hop changed. New neighbor is not resolved. Remove session.
-            if (session.status)
-            {
-                deactivateSession(name, session);
-            }
-            continue;
+            return;
         }
+    }
 
+    session.nexthopInfo.nexthop = *update.nexthopGroup.getIpAddresses().begin();
+    session.nexthopInfo.prefix = update.prefix;
+    session.nexthopInfo.resolved = true;
+
+    // Get neighbor
+    if (!getNeighborInfo(name, session))
+    {
+        // Next hop changed. New neighbor is not resolved. Remove session.
         if (session.status)
         {
-            if (!updateSessionDstMac(name, session))
-            {
-                continue;
-            }
-
-            if (!updateSessionDstPort(name, session))
-            {
-                continue;
-            }
+            deactivateSession(name, session);
         }
-        else
+        return;
+    }
+
+    if (session.status)
+    {
+        if (!updateSessionDstMac(name, session))
         {
-            if (!activateSession(name, session))
-            {
-                continue;
-            }
+            return;
         }
+
+        updateSessionDstPort(name, session);
+    }
+    else
+    {
+        activateSession(name, session);
     }
 }
 
@@ -620,183 +788,191 @@ void MirrorOrch::updateNeighbor(const NeighborUpdate& update)
 {
     SWSS_LOG_ENTER();
 
-    auto sessionIter = m_syncdMirrors.begin();
-    for (; sessionIter != m_syncdMirrors.end(); ++sessionIter)
+    // It is possible to have few sessions that points to one next hop
+    auto sessions = m_nextHopSessions.find(update.entry.ip_address);
+    if (sessions == m_nextHopSessions.end())
     {
-        if (!sessionIter->second.nexthopInfo.resolved)
-        {
-            continue;
-        }
+        return;
+    }
 
-        // It is possible to have few sessions that points to one next hop
-        if (sessionIter->second.nexthopInfo.nexthop != update.entry.ip_address)
-        {
-            continue;
-        }
+    set<string> names = sessions->second;
+    for (const auto& name : names)
+    {
+        auto& session = m_syncdMirrors.at(name);
 
-        SWSS_LOG_INFO("Updating neighbor info %s %s\n", update.entry.ip_address.to_string().c_str(), update.entry.alias.c_str());
+        updateSessionNeighbor(name, session, update);
+        indexSession(name, session);
+    }
+}
 
-        const auto& name = sessionIter->first;
-        auto& session = sessionIter->second;
+void MirrorOrch::updateSessionNeighbor(const string& name, MirrorEntry& session, const NeighborUpdate& update)
+{
+    SWSS_LOG_ENTER();
 
-        if (update.add)
-        {
-            if (!getNeighborInfo(name, session, update.entry, update.mac))
-            {
-                if (session.status)
-                {
-                    deactivateSession(name, session);
-                }
-               continue;
-            }
+    SWSS_LOG_INFO("Updating neighbor info %s %s\n", update.entry.ip_address.to_string().c_str(), update.entry.alias.c_str());
 
+    if (update.add)
+    {
+        if (!getNeighborInfo(name, session, update.entry, update.mac))
+        {
             if (session.status)
             {
-                if (!updateSessionDstMac(name, session))
-                {
-                    continue;
-                }
-
-                if (!updateSessionDstPort(name, session))
-                {
-                    continue;
-                }
+                deactivateSession(name, session);
             }
-            else
+            return;
+        }
+
+        if (session.status)
+        {
+            if (!updateSessionDstMac(name, session))
             {
-                activateSession(name, session);
+                return;
             }
+
+            updateSessionDstPort(name, session);
         }
-        else if (session.status)
+        else
         {
-            deactivateSession(name, session);
-            session.neighborInfo.resolved = false;
+            activateSession(name, session);
         }
     }
+    else if (session.status)
+    {
+        deactivateSession(name, session);
+        session.neighborInfo.resolved = false;
+    }
 }
 
 void MirrorOrch::updateFdb(const FdbUpdate& update)
 {
     SWSS_LOG_ENTER();
 
-    auto sessionIter = m_syncdMirrors.begin();
-    for (; sessionIter != m_syncdMirrors.end(); ++sessionIter)
+    // It is possible to have few session that points to one FDB entry
+    auto sessions = m_fdbSessions.find(update.entry);
+    if (sessions == m_fdbSessions.end())
     {
-        if (!sessionIter->second.neighborInfo.resolved ||
-                sessionIter->second.neighborInfo.port.m_type != Port::VLAN)
-        {
-            continue;
-        }
+        return;
+    }
 
-        // It is possible to have few session that points to one FDB entry
-        if (sessionIter->second.neighborInfo.mac != update.entry.mac ||
-                sessionIter->second.neighborInfo.vlanId != update.entry.vlan)
-        {
-            continue;
-        }
+    set<string> names = sessions->second;
+    for (const auto& name : names)
+    {
+        auto& session = m_syncdMirrors.at(name);
 
-        const auto& name = sessionIter->first;
-        auto& session = sessionIter->second;
+        updateSessionFdb(name, session, update);
+        indexSession(name, session);
+    }
+}
 
-        if (update.add)
+void MirrorOrch::updateSessionFdb(const string& name, MirrorEntry& session, const FdbUpdate& update)
+{
+    SWSS_LOG_ENTER();
+
+    if (update.add)
+    {
+        if (session.status)
         {
-            if (session.status)
-            {
-                // update port if changed
-                if (session.neighborInfo.portId != update.port.m_port_id)
-                {
-                    session.neighborInfo.portId = update.port.m_port_id;
-                    updateSessionDstPort(name, session);
-                }
-            }
-            else
+            // update port if changed
+            if (session.neighborInfo.portId != update.port.m_port_id)
             {
-                //activate session
-                session.neighborInfo.resolved = true;
-                session.neighborInfo.mac = update.entry.mac;
                 session.neighborInfo.portId = update.port.m_port_id;
-
-                activateSession(name, session);
+                updateSessionDstPort(name, session);
             }
         }
         else
         {
-            deactivateSession(name, session);
-            session.neighborInfo.portId = SAI_NULL_OBJECT_ID;
+            //activate session
+            session.neighborInfo.resolved = true;
+            session.neighborInfo.mac = update.entry.mac;
+            session.neighborInfo.portId = update.port.m_port_id;
+
+            activateSession(name, session);
         }
     }
+    else
+    {
+        deactivateSession(name, session);
+        session.neighborInfo.portId = SAI_NULL_OBJECT_ID;
+    }
 }
 
 void MirrorOrch::updateLagMember(const LagMemberUpdate& update)
 {
     SWSS_LOG_ENTER();
-    auto sessionIter = m_syncdMirrors.begin();
-    for (; sessionIter != m_syncdMirrors.end(); ++sessionIter)
+
+    // It is possible to have few session that points to one LAG member
+    auto sessions = m_portSessions.find(update.lag.m_alias);
+    if (sessions == m_portSessions.end())
     {
-        if (!sessionIter->second.neighborInfo.resolved)
+        return;
+    }
+
+    set<string> names = sessions->second;
+    for (const auto& name : names)
+    {
+        auto& session = m_syncdMirrors.at(name);
+
+        if (session.neighborInfo.port.m_type != Port::LAG ||
+                session.neighborInfo.portId != update.member.m_port_id)
         {
             continue;
         }
 
-        if (sessionIter->second.neighborInfo.port.m_type != Port::LAG)
+        updateSessionLagMember(name, session, update);
+        indexSession(name, session);
+    }
+}
+
+void MirrorOrch::updateSessionLagMember(const string& name, MirrorEntry& session, const LagMemberUpdate& update)
+{
+    SWSS_LOG_ENTER();
+
+    if (update.add)
+    {
+        // We interesting only in first LAG member
+        if (update.lag.m_members.size() > 1)
         {
-            continue;
+            return;
         }
 
-        // It is possible to have few session that points to one LAG member
-        if (sessionIter->second.neighborInfo.port != update.lag || sessionIter->second.neighborInfo.portId != update.member.m_port_id)
+        const string& memberName = *update.lag.m_members.begin();
+        Port *member = m_portsOrch->findPort(memberName);
+        if (!member)
         {
-            continue;
+            SWSS_LOG_ERROR("Failed to get port for %s alias\n", memberName.c_str());
+            assert(false);
+            return;
         }
 
-        const auto& name = sessionIter->first;
-        auto& session = sessionIter->second;
+        session.neighborInfo.portId = member->m_port_id;
 
-        if (update.add)
+        activateSession(name, session);
+    }
+    else
+    {
+        // If LAG is empty deactivate session
+        if (update.lag.m_members.empty())
         {
-            // We interesting only in first LAG member
-            if (update.lag.m_members.size() > 1)
-            {
-                continue;
-            }
-
-            const string& memberName = *update.lag.m_members.begin();
-            Port member;
-            if (!m_portsOrch->getPort(memberName, member))
-            {
-                SWSS_LOG_ERROR("Failed to get port for %s alias\n", memberName.c_str());
-                assert(false);
-            }
-
-            session.neighborInfo.portId = member.m_port_id;
+            deactivateSession(name, session);
+            session.neighborInfo.portId = SAI_OBJECT_TYPE_NULL;
 
-            activateSession(name, session);
+            return;
         }
-        else
-        {
-            // If LAG is empty deactivate session
-            if (update.lag.m_members.empty())
-            {
-                deactivateSession(name, session);
-                session.neighborInfo.portId = SAI_OBJECT_TYPE_NULL;
 
-                continue;
-            }
+        // Get another LAG member and update session
+        const string& memberName = *update.lag.m_members.begin();
 
-            // Get another LAG member and update session
-            const string& memberName = *update.lag.m_members.begin();
-
-            Port member;
-            if (!m_portsOrch->getPort(memberName, member))
-            {
-                SWSS_LOG_ERROR("Failed to get port for %s alias\n", memberName.c_str());
-                assert(false);
-            }
+        Port *member = m_portsOrch->findPort(memberName);
+        if (!member)
+        {
+            SWSS_LOG_ERROR("Failed to get port for %s alias\n", memberName.c_str());
+            assert(false);
+            return;
+        }
 
-            session.neighborInfo.portId = member.m_port_id;
+        session.neighborInfo.portId = member->m_port_id;
 
-            updateSessionDstPort(name, session);
-        }
+        updateSessionDstPort(name, session);
     }
 }
 
@@ -810,34 +986,38 @@ void MirrorOrch::updateVlanMember(const VlanMemberUpdate& update)
         return;
     }
 
-    auto sessionIter = m_syncdMirrors.begin();
-    for (; sessionIter != m_syncdMirrors.end(); ++sessionIter)
+    // It is possible to have few session that points to one VLAN member
+    auto sessions = m_portSessions.find(update.vlan.m_alias);
+    if (sessions == m_portSessions.end())
     {
-        if (!sessionIter->second.neighborInfo.resolved)
-        {
-            continue;
-        }
+        return;
+    }
 
-        if (sessionIter->second.neighborInfo.port.m_type != Port::VLAN)
-        {
-            continue;
-        }
+    set<string> names = sessions->second;
+    for (const auto& name : names)
+    {
+        auto& session = m_syncdMirrors.at(name);
 
-        // It is possible to have few session that points to one VLAN member
-        if (sessionIter->second.neighborInfo.port != update.vlan || sessionIter->second.neighborInfo.portId != update.member.m_port_id)
+        if (session.neighborInfo.port.m_type != Port::VLAN ||
+                session.neighborInfo.portId != update.member.m_port_id)
         {
             continue;
         }
 
-        const auto& name = sessionIter->first;
-        auto& session = sessionIter->second;
-
-        // Deactivate session. Wait for FDB event to activate session
-        deactivateSession(name, session);
-        session.neighborInfo.portId = SAI_OBJECT_TYPE_NULL;
+        updateSessionVlanMember(name, session, update);
+        indexSession(name, session);
     }
 }
 
+void MirrorOrch::updateSessionVlanMember(const string& name, MirrorEntry& session, const VlanMemberUpdate& update)
+{
+    SWSS_LOG_ENTER();
+
+    // Deactivate session. Wait for FDB event to activate session
+    deactivateSession(name, session);
+    session.neighborInfo.portId = SAI_OBJECT_TYPE_NULL;
+}
+
 void MirrorOrch::doTask(Consumer& consumer)
 {
     SWSS_LOG_ENTER();
@@ -866,3 +1046,16 @@ void MirrorOrch::doTask(Consumer& consumer)
         consumer.m_toSync.erase(it++);
     }
 }
+
+/*
+ * Runs once per OrchDaemon iteration, after the orchs whose changes notify
+ * the sessions, so that all session states of the iteration share one flush.
+ */
+void MirrorOrch::doTask()
+{
+    SWSS_LOG_ENTER();
+
+    Orch::doTask();
+
+    flushSessionStates();
+}
@@ -13,6 +13,7 @@
 #include "ipprefix.h"
 
 #include "producerstatetable.h"
+#include "redispipeline.h"
 
 #include <map>
 #include <inttypes.h>
@@ -49,6 +50,9 @@ struct MirrorEntry
         sai_object_id_t portId;
     } neighborInfo;
 
+    vector<sai_attribute_t> policerAttrs;
+    sai_object_id_t policerId;
+
     sai_object_id_t sessionId;
     int64_t refCount;
 
@@ -59,6 +63,7 @@ struct MirrorEntry
         ttl(0),
         queue(0),
         addVLanTag(false),
+        policerId(SAI_NULL_OBJECT_ID),
         sessionId(0),
         refCount(0)
     {
@@ -76,6 +81,25 @@ struct MirrorSessionUpdate
 /* MirrorTable: mirror session name, mirror session data */
 typedef map<string, MirrorEntry> MirrorTable;
 
+/* COUNTERS_DB table holding packets and bytes mirrored by each session */
+#define MIRROR_SESSION_COUNTERS_TABLE "MIRROR_SESSION_COUNTERS"
+
+/* Keys a session is currently stored under in the reverse indexes */
+struct MirrorSessionIndexKeys
+{
+    bool nexthop;
+    IpAddress nexthopIp;
+    bool port;
+    string portAlias;
+    bool fdb;
+    FdbEntry fdbEntry;
+};
+
+/* Reverse indexes: neighbor/FDB/port key, names of dependent sessions */
+typedef map<IpAddress, set<string>> MirrorIpIndex;
+typedef map<FdbEntry, set<string>> MirrorFdbIndex;
+typedef map<string, set<string>> MirrorPortIndex;
+
 class MirrorOrch : public Orch, public Observer, public Subject
 {
 public:
@@ -89,16 +113,31 @@ public:
     bool increaseRefCount(const string&);
     bool decreaseRefCount(const string&);
 
+    void doTask();
 private:
     PortsOrch *m_portsOrch;
     RouteOrch *m_routeOrch;
     NeighOrch *m_neighOrch;
     FdbOrch *m_fdbOrch;
 
+    RedisPipeline m_mirrorTablePipeline;
     ProducerStateTable m_mirrorTableProducer;
 
+    /* Session states changed in the current batch and last published ones */
+    map<string, bool> m_pendingSessionStates;
+    map<string, bool> m_publishedSessionStates;
+
     MirrorTable m_syncdMirrors;
 
+    MirrorIpIndex m_dstIpSessions;
+    MirrorIpIndex m_nextHopSessions;
+    MirrorFdbIndex m_fdbSessions;
+    MirrorPortIndex m_portSessions;
+    map<string, MirrorSessionIndexKeys> m_sessionIndexKeys;
+
+    void indexSession(const string&, const MirrorEntry&);
+    void unindexSession(const string&);
+
     void createEntry(const string&, const vector<FieldValueTuple>&);
     void deleteEntry(const string&);
 
@@ -107,6 +146,7 @@ private:
     bool updateSessionDstMac(const string&, MirrorEntry&);
     bool updateSessionDstPort(const string&, MirrorEntry&);
     bool setSessionState(const string&, MirrorEntry&);
+    void flushSessionStates();
     bool getNeighborInfo(const string&, MirrorEntry&);
     bool getNeighborInfo(const string&, MirrorEntry&, const NeighborEntry&, const MacAddress&);
 
@@ -116,6 +156,12 @@ private:
     void updateLagMember(const LagMemberUpdate&);
     void updateVlanMember(const VlanMemberUpdate&);
 
+    void updateSessionNextHop(const string&, MirrorEntry&, const NextHopUpdate&);
+    void updateSessionNeighbor(const string&, MirrorEntry&, const NeighborUpdate&);
+    void updateSessionFdb(const string&, MirrorEntry&, const FdbUpdate&);
+    void updateSessionLagMember(const string&, MirrorEntry&, const LagMemberUpdate&);
+    void updateSessionVlanMember(const string&, MirrorEntry&, const VlanMemberUpdate&);
+
     void doTask(Consumer& consumer);
 };
 
@@ -152,15 +152,15 @@ void NeighOrch::doTask(Consumer &consumer)
             continue;
         }
 
-        Port p;
-        if (!gPortsOrch->getPort(alias, p))
+        Port *p = gPortsOrch->findPort(alias);
+        if (!p)
         {
             SWSS_LOG_INFO("Port %s doesn't exist", alias.c_str());
             it++;
             continue;
         }
 
-        if (!p.m_rif_id)
+        if (!p->m_rif_id)
         {
             SWSS_LOG_INFO("Router interface doesn't exist on %s", alias.c_str());
             it = consumer.m_toSync.erase(it);
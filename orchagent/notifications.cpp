@@ -63,6 +63,8 @@ void on_port_state_change(uint32_t count, sai_port_oper_status_notification_t *d
 
         SWSS_LOG_NOTICE("Get port state change notification id:%lx status:%d", id, status);
 
+        /* Take a LAG member out of the hash first, teamd catches up later */
+        gPortsOrch->updateLagMemberEgress(id, status == SAI_PORT_OPER_STATUS_UP);
         gPortsOrch->updateDbPortOperStatus(id, status);
         gPortsOrch->setHostIntfsOperStatus(id, status == SAI_PORT_OPER_STATUS_UP);
     }
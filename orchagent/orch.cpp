@@ -21,6 +21,9 @@ extern bool gLogRotate;
 extern string gRecordFile;
 extern string getTimestamp();
 
+object_reference_map Orch::m_objectReferences;
+object_reference_map Orch::m_objectReferrers;
+
 Orch::Orch(DBConnector *db, string tableName) :
     m_db(db)
 {
@@ -194,7 +197,8 @@ ref_resolve_status Orch::resolveFieldRefValue(
     type_map &type_maps,
     const string &field_name,
     KeyOpFieldsValuesTuple &tuple,
-    sai_object_id_t &sai_object)
+    sai_object_id_t &sai_object,
+    set<string> *references)
 {
     SWSS_LOG_ENTER();
 
@@ -215,6 +219,10 @@ ref_resolve_status Orch::resolveFieldRefValue(
                 return ref_resolve_status::not_resolved;
             }
             sai_object = (*(type_maps[ref_type_name]))[object_name];
+            if (references)
+            {
+                references->insert(getObjectKey(ref_type_name, object_name));
+            }
             hit = true;
         }
     }
@@ -237,6 +245,93 @@ void Orch::doTask()
     }
 }
 
+void Orch::doTask(const vector<string> &tableNames)
+{
+    if (!gPortsOrch->isInitDone())
+        return;
+
+    for (auto &table_name : tableNames)
+    {
+        auto it = m_consumerMap.find(table_name);
+        if (it != m_consumerMap.end() && !it->second.m_toSync.empty())
+            doTask(it->second);
+    }
+}
+
+string Orch::getObjectKey(const string &table_name, const string &object_name)
+{
+    return table_name + delimiter + object_name;
+}
+
+void Orch::setObjectReferences(const string &referrer, const set<string> &references)
+{
+    SWSS_LOG_ENTER();
+
+    removeObjectReferences(referrer);
+    if (references.empty())
+    {
+        return;
+    }
+
+    m_objectReferences[referrer] = references;
+    for (auto &object : references)
+    {
+        m_objectReferrers[object].insert(referrer);
+        SWSS_LOG_DEBUG("%s references %s", referrer.c_str(), object.c_str());
+    }
+}
+
+void Orch::removeObjectReferences(const string &referrer)
+{
+    SWSS_LOG_ENTER();
+
+    auto it = m_objectReferences.find(referrer);
+    if (it == m_objectReferences.end())
+    {
+        return;
+    }
+
+    for (auto &object : it->second)
+    {
+        auto referrers = m_objectReferrers.find(object);
+        if (referrers == m_objectReferrers.end())
+        {
+            continue;
+        }
+        referrers->second.erase(referrer);
+        if (referrers->second.empty())
+        {
+            m_objectReferrers.erase(referrers);
+        }
+    }
+    m_objectReferences.erase(it);
+}
+
+set<string> Orch::getObjectReferences(const string &referrer)
+{
+    auto it = m_objectReferences.find(referrer);
+    if (it == m_objectReferences.end())
+    {
+        return set<string>();
+    }
+    return it->second;
+}
+
+set<string> Orch::getObjectReferrers(const string &object)
+{
+    auto it = m_objectReferrers.find(object);
+    if (it == m_objectReferrers.end())
+    {
+        return set<string>();
+    }
+    return it->second;
+}
+
+bool Orch::isObjectReferenced(const string &object)
+{
+    return m_objectReferrers.find(object) != m_objectReferrers.end();
+}
+
 void Orch::logfileReopen()
 {
     gRecordOfs.close();
@@ -279,7 +374,8 @@ ref_resolve_status Orch::resolveFieldRefArray(
     type_map &type_maps,
     const string &field_name,
     KeyOpFieldsValuesTuple &tuple,
-    vector<sai_object_id_t> &sai_object_arr)
+    vector<sai_object_id_t> &sai_object_arr,
+    set<string> *references)
 {
     // example: [BUFFER_PROFILE_TABLE:e_port.profile0],[BUFFER_PROFILE_TABLE:e_port.profile1]
     SWSS_LOG_ENTER();
@@ -315,6 +411,10 @@ ref_resolve_status Orch::resolveFieldRefArray(
                 sai_object_id_t sai_obj = (*(type_maps[ref_type_name]))[object_name];
                 SWSS_LOG_DEBUG("Resolved to sai_object:0x%lx, type:%s, name:%s", sai_obj, ref_type_name.c_str(), object_name.c_str());
                 sai_object_arr.push_back(sai_obj);
+                if (references)
+                {
+                    references->insert(getObjectKey(ref_type_name, object_name));
+                }
             }
             count++;
         }
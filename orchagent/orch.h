@@ -3,6 +3,7 @@
 
 #include <map>
 #include <memory>
+#include <set>
 
 extern "C" {
 #include "sai.h"
@@ -39,6 +40,12 @@ typedef pair<string, sai_object_id_t> object_map_pair;
 typedef map<string, object_map*> type_map;
 typedef pair<string, object_map*> type_map_pair;
 
+/*
+ * Object reference graph, nodes are named "<table>:<key>", for example
+ * "BUFFER_PROFILE_TABLE:ingress_lossless_profile" or "QUEUE_TABLE:Ethernet0:3"
+ */
+typedef map<string, set<string>> object_reference_map;
+
 typedef map<string, KeyOpFieldsValuesTuple> SyncMap;
 struct Consumer {
     Consumer(TableConsumable* consumer) : m_consumer(consumer)  { }
@@ -70,7 +77,15 @@ public:
 
     bool execute(string tableName);
     /* Iterate all consumers in m_consumerMap and run doTask(Consumer) */
-    void doTask();
+    virtual void doTask();
+
+    static string getObjectKey(const string &table_name, const string &object_name);
+    /* Replace the objects referenced by referrer with the given set */
+    static void setObjectReferences(const string &referrer, const set<string> &references);
+    static void removeObjectReferences(const string &referrer);
+    static set<string> getObjectReferences(const string &referrer);
+    static set<string> getObjectReferrers(const string &object);
+    static bool isObjectReferenced(const string &object);
 
 protected:
     DBConnector *m_db;
@@ -80,10 +95,18 @@ protected:
     virtual void doTask(Consumer &consumer) = 0;
     void logfileReopen();
     void recordTuple(Consumer &consumer, KeyOpFieldsValuesTuple &tuple);
-    ref_resolve_status resolveFieldRefValue(type_map&, const string&, KeyOpFieldsValuesTuple&, sai_object_id_t&);
+    ref_resolve_status resolveFieldRefValue(type_map&, const string&, KeyOpFieldsValuesTuple&, sai_object_id_t&, set<string> *references = NULL);
     bool parseIndexRange(const string &input, sai_uint32_t &range_low, sai_uint32_t &range_high);
     bool parseReference(type_map &type_maps, string &ref, string &table_name, string &object_name);
-    ref_resolve_status resolveFieldRefArray(type_map&, const string&, KeyOpFieldsValuesTuple&, vector<sai_object_id_t>&);
+    ref_resolve_status resolveFieldRefArray(type_map&, const string&, KeyOpFieldsValuesTuple&, vector<sai_object_id_t>&, set<string> *references = NULL);
+    /* Run doTask(Consumer) against the consumers of the given tables in order */
+    void doTask(const vector<string> &tableNames);
+
+private:
+    /* Forward edges: referrer -> referenced objects */
+    static object_reference_map m_objectReferences;
+    /* Reverse edges: referenced object -> referrers */
+    static object_reference_map m_objectReferrers;
 };
 
 #endif /* SWSS_ORCH_H */
@@ -14,11 +14,16 @@ using namespace swss;
 
 extern sai_switch_api_t*           sai_switch_api;
 extern sai_object_id_t             gSwitchId;
+extern mutex                       gDbMutex;
 
 /* Global variable gPortsOrch declared */
 PortsOrch *gPortsOrch;
 /* Global variable gFdbOrch declared */
 FdbOrch *gFdbOrch;
+/* Global variable gRouteOrch declared */
+RouteOrch *gRouteOrch;
+/* Global variable gCounterPollOrch declared */
+CounterPollOrch *gCounterPollOrch;
 
 OrchDaemon::OrchDaemon(DBConnector *applDb) :
         m_applDb(applDb)
@@ -50,10 +55,12 @@ bool OrchDaemon::init()
     };
 
     gPortsOrch = new PortsOrch(m_applDb, ports_tables);
+    /* Created before the orchs that register objects to poll */
+    gCounterPollOrch = new CounterPollOrch(m_applDb, APP_COUNTER_POLL_TABLE_NAME);
     gFdbOrch = new FdbOrch(m_applDb, APP_FDB_TABLE_NAME, gPortsOrch);
     IntfsOrch *intfs_orch = new IntfsOrch(m_applDb, APP_INTF_TABLE_NAME);
     NeighOrch *neigh_orch = new NeighOrch(m_applDb, APP_NEIGH_TABLE_NAME, intfs_orch);
-    RouteOrch *route_orch = new RouteOrch(m_applDb, APP_ROUTE_TABLE_NAME, neigh_orch);
+    gRouteOrch = new RouteOrch(m_applDb, APP_ROUTE_TABLE_NAME, neigh_orch);
     CoppOrch  *copp_orch  = new CoppOrch(m_applDb, APP_COPP_TABLE_NAME);
     TunnelDecapOrch *tunnel_decap_orch = new TunnelDecapOrch(m_applDb, APP_TUNNEL_DECAP_TABLE_NAME);
 
@@ -80,15 +87,15 @@ bool OrchDaemon::init()
     };
     BufferOrch *buffer_orch = new BufferOrch(m_applDb, buffer_tables);
 
-    MirrorOrch *mirror_orch = new MirrorOrch(m_applDb, APP_MIRROR_SESSION_TABLE_NAME, gPortsOrch, route_orch, neigh_orch, gFdbOrch);
+    MirrorOrch *mirror_orch = new MirrorOrch(m_applDb, APP_MIRROR_SESSION_TABLE_NAME, gPortsOrch, gRouteOrch, neigh_orch, gFdbOrch);
 
     vector<string> acl_tables = {
         APP_ACL_TABLE_NAME,
         APP_ACL_RULE_TABLE_NAME
     };
-    AclOrch *acl_orch = new AclOrch(m_applDb, acl_tables, gPortsOrch, mirror_orch, neigh_orch, route_orch);
+    AclOrch *acl_orch = new AclOrch(m_applDb, acl_tables, gPortsOrch, mirror_orch, neigh_orch, gRouteOrch);
 
-    m_orchList = { switch_orch, gPortsOrch, intfs_orch, neigh_orch, route_orch, copp_orch, tunnel_decap_orch, qos_orch, buffer_orch, mirror_orch, acl_orch, gFdbOrch};
+    m_orchList = { switch_orch, gPortsOrch, intfs_orch, neigh_orch, gRouteOrch, copp_orch, tunnel_decap_orch, qos_orch, buffer_orch, mirror_orch, acl_orch, gFdbOrch, gCounterPollOrch};
     m_select = new Select();
 
     vector<string> pfc_wd_tables = {
@@ -159,6 +166,8 @@ void OrchDaemon::start()
          * execute all the remaining tasks that need to be retried. */
 
         /* TODO: Abstract Orch class to have a specific todo list */
+        /* SAI notification handlers update the orchs under gDbMutex */
+        lock_guard<mutex> lock(gDbMutex);
         for (Orch *o : m_orchList)
             o->doTask();
 
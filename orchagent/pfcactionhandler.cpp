@@ -1,6 +1,7 @@
 #include "pfcactionhandler.h"
 #include "logger.h"
 #include "saiserialize.h"
+#include "schema.h"
 
 #include <vector>
 
@@ -14,11 +15,18 @@
 #define SAI_QUEUE_STAT_PACKETS_STR         "SAI_QUEUE_STAT_PACKETS"
 #define SAI_QUEUE_STAT_DROPPED_PACKETS_STR "SAI_QUEUE_STAT_DROPPED_PACKETS"
 
+#define PFC_WD_STORM_HISTORY_SIZE       16
+
 extern sai_object_id_t gSwitchId;
 extern sai_port_api_t *sai_port_api;
 extern sai_queue_api_t *sai_queue_api;
 extern sai_buffer_api_t *sai_buffer_api;
 
+mutex PfcWdActionHandler::s_mutex;
+map<string, PfcWdActionHandler::PfcWdQueueStats> PfcWdActionHandler::s_pendingStats;
+map<sai_object_id_t, PfcWdActionHandler::PfcWdStormRing> PfcWdActionHandler::s_stormHistory;
+set<sai_object_id_t> PfcWdActionHandler::s_pendingHistory;
+
 PfcWdActionHandler::PfcWdActionHandler(sai_object_id_t port, sai_object_id_t queue,
         uint8_t queueId, shared_ptr<Table> countersTable):
     m_port(port),
@@ -38,6 +46,7 @@ PfcWdActionHandler::PfcWdActionHandler(sai_object_id_t port, sai_object_id_t que
     m_stats.operational = false;
 
     updateWdCounters(sai_serialize_object_id(m_queue), m_stats);
+    recordStorm();
 }
 
 PfcWdActionHandler::~PfcWdActionHandler(void)
@@ -57,6 +66,7 @@ PfcWdActionHandler::~PfcWdActionHandler(void)
     finalStats.operational = true;
 
     updateWdCounters(sai_serialize_object_id(m_queue), finalStats);
+    recordRestore();
 }
 
 PfcWdActionHandler::PfcWdQueueStats PfcWdActionHandler::getQueueStats(shared_ptr<Table> countersTable, const string &queueIdStr)
@@ -98,6 +108,17 @@ PfcWdActionHandler::PfcWdQueueStats PfcWdActionHandler::getQueueStats(shared_ptr
         }
     }
 
+    // Watchdog stats not flushed yet are newer than the ones in the DB
+    lock_guard<mutex> lock(s_mutex);
+
+    auto pending = s_pendingStats.find(queueIdStr);
+    if (pending != s_pendingStats.end())
+    {
+        stats.detectCount = pending->second.detectCount;
+        stats.restoreCount = pending->second.restoreCount;
+        stats.operational = pending->second.operational;
+    }
+
     return move(stats);
 }
 
@@ -120,15 +141,109 @@ void PfcWdActionHandler::updateWdCounters(const string& queueIdStr, const PfcWdQ
 {
     SWSS_LOG_ENTER();
 
-    vector<FieldValueTuple> resultFvValues;
+    lock_guard<mutex> lock(s_mutex);
 
-    resultFvValues.emplace_back(PFC_WD_QUEUE_STATS_DEADLOCK_DETECTED, to_string(stats.detectCount));
-    resultFvValues.emplace_back(PFC_WD_QUEUE_STATS_DEADLOCK_RESTORED, to_string(stats.restoreCount));
-    resultFvValues.emplace_back(PFC_WD_QUEUE_STATUS, stats.operational ?
-                                                     PFC_WD_QUEUE_STATUS_OPERATIONAL :
-                                                     PFC_WD_QUEUE_STATUS_STORMED);
+    s_pendingStats[queueIdStr] = stats;
+}
+
+void PfcWdActionHandler::recordStorm(void)
+{
+    SWSS_LOG_ENTER();
+
+    m_detectStart = chrono::steady_clock::now();
+
+    PfcWdStormEvent event = { m_queue, m_queueId, chrono::system_clock::now(), m_detectStart,
+                              chrono::milliseconds(0), false };
+
+    lock_guard<mutex> lock(s_mutex);
+
+    auto& ring = s_stormHistory[m_port];
+    if (ring.events.size() < PFC_WD_STORM_HISTORY_SIZE)
+    {
+        ring.events.push_back(event);
+    }
+    else
+    {
+        ring.events[ring.next] = event;
+    }
+
+    ring.next = (ring.next + 1) % PFC_WD_STORM_HISTORY_SIZE;
+    s_pendingHistory.insert(m_port);
+}
+
+void PfcWdActionHandler::recordRestore(void)
+{
+    SWSS_LOG_ENTER();
+
+    auto duration = chrono::duration_cast<chrono::milliseconds>(
+            chrono::steady_clock::now() - m_detectStart);
+
+    lock_guard<mutex> lock(s_mutex);
+
+    // The storm may have been overwritten by newer ones
+    for (auto& event : s_stormHistory[m_port].events)
+    {
+        if (event.queue == m_queue && event.detectStart == m_detectStart)
+        {
+            event.duration = duration;
+            event.restored = true;
+            s_pendingHistory.insert(m_port);
+            break;
+        }
+    }
+}
+
+void PfcWdActionHandler::flushWdCounters(RedisPipeline &pipeline, Table &countersTable, Table &historyTable)
+{
+    SWSS_LOG_ENTER();
+
+    lock_guard<mutex> lock(s_mutex);
+
+    if (s_pendingStats.empty() && s_pendingHistory.empty())
+    {
+        return;
+    }
+
+    for (const auto& pending : s_pendingStats)
+    {
+        const auto& stats = pending.second;
+        vector<FieldValueTuple> resultFvValues;
+
+        resultFvValues.emplace_back(PFC_WD_QUEUE_STATS_DEADLOCK_DETECTED, to_string(stats.detectCount));
+        resultFvValues.emplace_back(PFC_WD_QUEUE_STATS_DEADLOCK_RESTORED, to_string(stats.restoreCount));
+        resultFvValues.emplace_back(PFC_WD_QUEUE_STATUS, stats.operational ?
+                                                         PFC_WD_QUEUE_STATUS_OPERATIONAL :
+                                                         PFC_WD_QUEUE_STATUS_STORMED);
+
+        countersTable.set(pending.first, resultFvValues);
+    }
+
+    // History is published newest first as
+    // <queue index>|<detection time in ms since epoch>|<duration in ms or "ongoing">
+    for (sai_object_id_t port : s_pendingHistory)
+    {
+        const auto& ring = s_stormHistory[port];
+        size_t size = ring.events.size();
+        vector<FieldValueTuple> resultFvValues;
+
+        for (size_t i = 0; i < size; i++)
+        {
+            const auto& event = ring.events[(ring.next + size - 1 - i) % size];
+            auto detectTime = chrono::duration_cast<chrono::milliseconds>(
+                    event.detectTime.time_since_epoch()).count();
+
+            resultFvValues.emplace_back(to_string(i),
+                    to_string(event.queueIndex) + "|" + to_string(detectTime) + "|" +
+                    (event.restored ? to_string(event.duration.count()) : "ongoing"));
+        }
+
+        historyTable.set(sai_serialize_object_id(port), resultFvValues);
+    }
+
+    pipeline.flush();
 
-    m_countersTable->set(queueIdStr, resultFvValues);
+    s_pendingStats.clear();
+    s_pendingHistory.clear();
 }
 
 PfcWdLossyHandler::PfcWdLossyHandler(sai_object_id_t port, sai_object_id_t queue,
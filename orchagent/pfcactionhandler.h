@@ -3,8 +3,13 @@
 
 #include <vector>
 #include <memory>
+#include <map>
+#include <set>
+#include <mutex>
+#include <chrono>
 
 #include "table.h"
+#include "redispipeline.h"
 
 extern "C" {
 #include "sai.h"
@@ -13,6 +18,21 @@ extern "C" {
 using namespace std;
 using namespace swss;
 
+#define PFC_WD_STORM_HISTORY_TABLE "PFC_WD_STORM_HISTORY"
+
+// Storm of a queue. Duration is known once the queue is restored
+struct PfcWdStormEvent
+{
+    sai_object_id_t queue;
+    uint8_t queueIndex;
+    // Wall clock time, only published
+    chrono::system_clock::time_point detectTime;
+    // Monotonic time the duration is measured from
+    chrono::steady_clock::time_point detectStart;
+    chrono::milliseconds duration;
+    bool restored;
+};
+
 // PFC queue interface class
 // It resembles RAII behavior - pause storm is mitigated (queue is locked) on creation,
 // and is restored (queue released) on removal
@@ -39,6 +59,8 @@ class PfcWdActionHandler
         }
 
         static void initWdCounters(shared_ptr<Table> countersTable, const string &queueIdStr);
+        // Write stats and storm history changed since the last call with one pipeline flush
+        static void flushWdCounters(RedisPipeline &pipeline, Table &countersTable, Table &historyTable);
 
     private:
         struct PfcWdQueueStats
@@ -50,14 +72,32 @@ class PfcWdActionHandler
             bool     operational  = true;
         };
 
+        // Ring of the last storms of a port
+        struct PfcWdStormRing
+        {
+            vector<PfcWdStormEvent> events;
+            size_t next = 0;
+        };
+
         static PfcWdQueueStats getQueueStats(shared_ptr<Table> countersTable, const string &queueIdStr);
         void updateWdCounters(const string& queueIdStr, const PfcWdQueueStats& stats);
+        void recordStorm(void);
+        void recordRestore(void);
 
         sai_object_id_t m_port = SAI_NULL_OBJECT_ID;
         sai_object_id_t m_queue = SAI_NULL_OBJECT_ID;
         uint8_t m_queueId = 0;
         shared_ptr<Table> m_countersTable = nullptr;
         PfcWdQueueStats m_stats;
+        chrono::steady_clock::time_point m_detectStart;
+
+        // Guards the pending updates and the storm history. Handlers are
+        // created by the poller thread and released by the orch thread too.
+        static mutex s_mutex;
+        // Stats waiting to be written to COUNTERS_DB, keyed by queue ID
+        static map<string, PfcWdQueueStats> s_pendingStats;
+        static map<sai_object_id_t, PfcWdStormRing> s_stormHistory;
+        static set<sai_object_id_t> s_pendingHistory;
 };
 
 // Pfc queue that implements forward action by disabling PFC on queue
@@ -4,6 +4,8 @@
 #include "converter.h"
 #include "redisapi.h"
 
+#include <hiredis/hiredis.h>
+
 #define PFC_WD_ACTION                   "action"
 #define PFC_WD_DETECTION_TIME           "detection_time"
 #define PFC_WD_RESTORATION_TIME         "restoration_time"
@@ -13,10 +15,74 @@
 #define PFC_WD_RESTORATION_TIME_MAX     (60 * 1000)
 #define PFC_WD_RESTORATION_TIME_MIN     100
 #define PFC_WD_TC_MAX                   8
+#define PFC_WD_DEBUG_STORM              "DEBUG_STORM"
+#define PFC_WD_DEBUG_STORM_ENABLED      "enabled"
 
 extern sai_port_api_t *sai_port_api;
 extern sai_queue_api_t *sai_queue_api;
 extern PortsOrch *gPortsOrch;
+extern bool gPfcWdLuaDetection;
+
+static const vector<sai_port_stat_t> PfcDurationIdMap =
+{
+    SAI_PORT_STAT_PFC_0_RX_PAUSE_DURATION,
+    SAI_PORT_STAT_PFC_1_RX_PAUSE_DURATION,
+    SAI_PORT_STAT_PFC_2_RX_PAUSE_DURATION,
+    SAI_PORT_STAT_PFC_3_RX_PAUSE_DURATION,
+    SAI_PORT_STAT_PFC_4_RX_PAUSE_DURATION,
+    SAI_PORT_STAT_PFC_5_RX_PAUSE_DURATION,
+    SAI_PORT_STAT_PFC_6_RX_PAUSE_DURATION,
+    SAI_PORT_STAT_PFC_7_RX_PAUSE_DURATION,
+};
+
+static const vector<sai_port_stat_t> PfcRxPktsIdMap =
+{
+    SAI_PORT_STAT_PFC_0_RX_PKTS,
+    SAI_PORT_STAT_PFC_1_RX_PKTS,
+    SAI_PORT_STAT_PFC_2_RX_PKTS,
+    SAI_PORT_STAT_PFC_3_RX_PKTS,
+    SAI_PORT_STAT_PFC_4_RX_PKTS,
+    SAI_PORT_STAT_PFC_5_RX_PKTS,
+    SAI_PORT_STAT_PFC_6_RX_PKTS,
+    SAI_PORT_STAT_PFC_7_RX_PKTS,
+};
+
+static bool getCounterValue(const redisReply *reply, uint64_t& value)
+{
+    if (reply->type != REDIS_REPLY_STRING)
+    {
+        return false;
+    }
+
+    /* A malformed value is treated as a missing counter */
+    try
+    {
+        value = stoull(string(reply->str, reply->len));
+    }
+    catch (const exception &)
+    {
+        return false;
+    }
+
+    return true;
+}
+
+void PfcWdCounterBatch::resize(size_t size)
+{
+    occupancyBytes.assign(size, 0);
+    packets.assign(size, 0);
+    packetsLast.assign(size, 0);
+    pfcRxPackets.assign(size, 0);
+    pfcRxPacketsLast.assign(size, 0);
+    pfcDuration.assign(size, 0);
+    pfcDurationLast.assign(size, 0);
+    pollTime.assign(size, 0);
+    present.assign(size, 0);
+    valid.assign(size, 0);
+    pfcRxPresent.assign(size, 0);
+    pfcRxValid.assign(size, 0);
+    debugStorm.assign(size, 0);
+}
 
 template <typename DropHandler, typename ForwardHandler>
 PfcWdOrch<DropHandler, ForwardHandler>::PfcWdOrch(DBConnector *db, vector<string> &tableNames):
@@ -24,7 +90,11 @@ PfcWdOrch<DropHandler, ForwardHandler>::PfcWdOrch(DBConnector *db, vector<string
     m_pfcWdDb(new DBConnector(PFC_WD_DB, DBConnector::DEFAULT_UNIXSOCKET, 0)),
     m_countersDb(new DBConnector(COUNTERS_DB, DBConnector::DEFAULT_UNIXSOCKET, 0)),
     m_pfcWdTable(new ProducerStateTable(m_pfcWdDb.get(), PFC_WD_STATE_TABLE)),
-    m_countersTable(new Table(m_countersDb.get(), COUNTERS_TABLE))
+    m_countersTable(new Table(m_countersDb.get(), COUNTERS_TABLE)),
+    m_wdCountersDb(new DBConnector(COUNTERS_DB, DBConnector::DEFAULT_UNIXSOCKET, 0)),
+    m_wdCountersPipeline(new RedisPipeline(m_wdCountersDb.get())),
+    m_wdCountersTable(new Table(m_wdCountersPipeline.get(), COUNTERS_TABLE, true)),
+    m_stormHistoryTable(new Table(m_wdCountersPipeline.get(), PFC_WD_STORM_HISTORY_TABLE, true))
 {
     SWSS_LOG_ENTER();
 }
@@ -145,14 +215,14 @@ void PfcWdOrch<DropHandler, ForwardHandler>::createEntry(const string& key,
     // According to requirements, drop action is default
     PfcWdAction action = PfcWdAction::PFC_WD_ACTION_DROP;
 
-    Port port;
-    if (!gPortsOrch->getPort(key, port))
+    Port *port = gPortsOrch->findPort(key);
+    if (!port)
     {
         SWSS_LOG_ERROR("Invalid port interface %s", key.c_str());
         return;
     }
 
-    if (port.m_type != Port::PHY)
+    if (port->m_type != Port::PHY)
     {
         SWSS_LOG_ERROR("Interface %s is not physical port", key.c_str());
         return;
@@ -228,15 +298,15 @@ void PfcWdOrch<DropHandler, ForwardHandler>::createEntry(const string& key,
         return;
     }
 
-    registerInWdDb(port);
+    registerInWdDb(*port);
 
-    if (!startWdOnPort(port, detectionTime, restorationTime, action))
+    if (!startWdOnPort(*port, detectionTime, restorationTime, action))
     {
-        SWSS_LOG_ERROR("Failed to start PFC Watchdog on port %s", port.m_alias.c_str());
+        SWSS_LOG_ERROR("Failed to start PFC Watchdog on port %s", port->m_alias.c_str());
         return;
     }
 
-    SWSS_LOG_NOTICE("Started PFC Watchdog on port %s", port.m_alias.c_str());
+    SWSS_LOG_NOTICE("Started PFC Watchdog on port %s", port->m_alias.c_str());
 }
 
 template <typename DropHandler, typename ForwardHandler>
@@ -244,20 +314,35 @@ void PfcWdOrch<DropHandler, ForwardHandler>::deleteEntry(const string& name)
 {
     SWSS_LOG_ENTER();
 
-    Port port;
-    gPortsOrch->getPort(name, port);
+    Port *port = gPortsOrch->findPort(name);
+    if (!port)
+    {
+        SWSS_LOG_ERROR("Invalid port interface %s", name.c_str());
+        return;
+    }
 
-    if (!stopWdOnPort(port))
+    if (!stopWdOnPort(*port))
     {
         SWSS_LOG_ERROR("Failed to stop PFC Watchdog on port %s", name.c_str());
         return;
     }
 
-    unregisterFromWdDb(port);
+    unregisterFromWdDb(*port);
+
+    // Stopping restores stormed queues, publish it right away
+    flushWdCounters();
 
     SWSS_LOG_NOTICE("Stopped PFC Watchdog on port %s", name.c_str());
 }
 
+template <typename DropHandler, typename ForwardHandler>
+void PfcWdOrch<DropHandler, ForwardHandler>::flushWdCounters(void)
+{
+    SWSS_LOG_ENTER();
+
+    PfcWdActionHandler::flushWdCounters(*m_wdCountersPipeline, *m_wdCountersTable, *m_stormHistoryTable);
+}
+
 template <typename DropHandler, typename ForwardHandler>
 void PfcWdOrch<DropHandler, ForwardHandler>::registerInWdDb(const Port& port)
 {
@@ -340,13 +425,17 @@ PfcWdSwOrch<DropHandler, ForwardHandler>::~PfcWdSwOrch(void)
 template <typename DropHandler, typename ForwardHandler>
 PfcWdSwOrch<DropHandler, ForwardHandler>::PfcWdQueueEntry::PfcWdQueueEntry(
         uint32_t detectionTime, uint32_t restorationTime,
-        PfcWdAction action, sai_object_id_t port, uint8_t idx):
+        PfcWdAction action, sai_object_id_t port, uint8_t idx,
+        const string& queueIdStr):
     c_detectionTime(detectionTime),
     c_restorationTime(restorationTime),
     c_action(action),
-    pollTimeLeft(c_detectionTime),
     portId(port),
-    index(idx)
+    c_queueIdStr(queueIdStr),
+    nextPoll(chrono::steady_clock::now() + chrono::milliseconds(detectionTime)),
+    index(idx),
+    c_pfcRxPacketsField(sai_serialize_port_stat(PfcRxPktsIdMap[idx])),
+    c_pfcDurationField(sai_serialize_port_stat(PfcDurationIdMap[idx]))
 {
     SWSS_LOG_ENTER();
 }
@@ -430,13 +519,19 @@ bool PfcWdSwOrch<DropHandler, ForwardHandler>::startWdOnQueue(sai_object_id_t qu
             return false;
         }
 
-        m_entryMap.emplace(queueId, PfcWdQueueEntry(detectionTime,
+        auto inserted = m_entryMap.emplace(queueId, PfcWdQueueEntry(detectionTime,
                                                     restorationTime,
                                                     action,
                                                     portId,
-                                                    idx));
+                                                    idx,
+                                                    sai_serialize_object_id(queueId)));
+
+        m_pollEvents.emplace(inserted.first->second.nextPoll, queueId);
     }
 
+    // Wake up the thread in case it sleeps past the new deadline
+    m_cvSleep.notify_all();
+
     if (!m_runPfcWdSwOrchThread.load())
     {
         startWatchdogThread();
@@ -453,8 +548,13 @@ bool PfcWdSwOrch<DropHandler, ForwardHandler>::stopWdOnQueue(sai_object_id_t que
     {
         unique_lock<mutex> lk(m_pfcWdMutex);
 
-        // Remove from internal DB
+        // Remove from internal DB. Its poll event is dropped lazily
         m_entryMap.erase(queueId);
+
+        if (m_entryMap.empty())
+        {
+            m_pollEvents = decltype(m_pollEvents)();
+        }
     }
 
     if (m_entryMap.empty())
@@ -466,88 +566,81 @@ bool PfcWdSwOrch<DropHandler, ForwardHandler>::stopWdOnQueue(sai_object_id_t que
 }
 
 template <typename DropHandler, typename ForwardHandler>
-uint32_t PfcWdSwOrch<DropHandler, ForwardHandler>::getNearestPollTime(void)
+chrono::steady_clock::time_point PfcWdSwOrch<DropHandler, ForwardHandler>::getNearestPollTime(void)
 {
     SWSS_LOG_ENTER();
 
-    uint32_t nearestTime = 0;
+    unique_lock<mutex> lk(m_pfcWdMutex);
 
-    for (const auto& queueKv : m_entryMap)
+    // Drop events of queues which were stopped or rescheduled
+    while (!m_pollEvents.empty())
     {
-        const PfcWdQueueEntry& queueEntry = queueKv.second;
-
-        // First check regular polling intervals
-        if (nearestTime == 0 || queueEntry.pollTimeLeft < nearestTime)
+        const auto& event = m_pollEvents.top();
+        auto it = m_entryMap.find(event.second);
+        if (it != m_entryMap.end() && it->second.nextPoll == event.first)
         {
-            nearestTime = queueEntry.pollTimeLeft;
+            return event.first;
         }
+
+        m_pollEvents.pop();
     }
 
-    return nearestTime;
+    return chrono::steady_clock::now() + chrono::milliseconds(PFC_WD_DETECTION_TIME_MAX);
 }
 
 template <typename DropHandler, typename ForwardHandler>
-void PfcWdSwOrch<DropHandler, ForwardHandler>::pollQueues(uint32_t nearestTime, DBConnector& db,
-        string detectSha, string restoreSha)
+void PfcWdSwOrch<DropHandler, ForwardHandler>::pollQueues(DBConnector& db,
+        const string& detectSha, const string& restoreSha)
 {
     SWSS_LOG_ENTER();
 
     unique_lock<mutex> lk(m_pfcWdMutex);
 
+    auto now = chrono::steady_clock::now();
+
     // Select those queues for which timer expired
-    vector<string> normalQueues;
-    vector<string> stormedQueues;
-    for (const auto& queueKv : m_entryMap)
+    vector<sai_object_id_t> expiredQueues;
+    while (!m_pollEvents.empty() && m_pollEvents.top().first <= now)
     {
-        sai_object_id_t queueId = queueKv.first;
-        const PfcWdQueueEntry& queueEntry = queueKv.second;
+        PfcWdPollEvent event = m_pollEvents.top();
+        m_pollEvents.pop();
 
-        if (queueEntry.pollTimeLeft == nearestTime)
+        auto it = m_entryMap.find(event.second);
+        if (it == m_entryMap.end() || it->second.nextPoll != event.first)
         {
-            // Queue is being stormed
-            if (queueEntry.handler != nullptr)
-            {
-                stormedQueues.push_back(sai_serialize_object_id(queueId));
-            }
-            // Queue is not stormed
-            else
-            {
-                normalQueues.push_back(sai_serialize_object_id(queueId));
-            }
+            continue;
         }
+
+        expiredQueues.push_back(event.second);
     }
 
-    // Run scripts for selected queues to see if their state changed
-    // from normal to stormed and vice versa
-    set<string> stormCheckReply;
-    set<string> restoreCheckReply;
-    vector<string> argv =
+    if (expiredQueues.empty())
     {
-        to_string(COUNTERS_DB),
-        COUNTERS_TABLE,
-        to_string(nearestTime * 1000)
-    };
+        return;
+    }
+
+    // Check if state of selected queues changed
+    // from normal to stormed and vice versa
+    vector<uint8_t> stormed;
+    vector<uint8_t> restored;
 
-    if (!normalQueues.empty())
+    if (gPfcWdLuaDetection)
     {
-        stormCheckReply = runRedisScript(db, detectSha, normalQueues, argv);
+        checkQueuesLua(db, detectSha, restoreSha, expiredQueues, stormed, restored);
     }
-
-    if (!stormedQueues.empty())
+    else
     {
-        restoreCheckReply = runRedisScript(db, restoreSha, stormedQueues, argv);
+        checkQueuesNative(db, expiredQueues, stormed, restored);
     }
 
-    // Update internal state of queues and their time
-    for (auto& queueKv : m_entryMap)
+    // Update internal state of polled queues and schedule their next poll
+    for (size_t i = 0; i < expiredQueues.size(); i++)
     {
-        sai_object_id_t queueId = queueKv.first;
-        PfcWdQueueEntry& queueEntry = queueKv.second;
-
-        string queueIdStr = sai_serialize_object_id(queueId);
+        sai_object_id_t queueId = expiredQueues[i];
+        PfcWdQueueEntry& queueEntry = m_entryMap.at(queueId);
 
         // Queue became stormed
-        if (stormCheckReply.find(queueIdStr) != stormCheckReply.end())
+        if (stormed[i])
         {
             if (queueEntry.c_action == PfcWdAction::PFC_WD_ACTION_DROP)
             {
@@ -569,50 +662,239 @@ void PfcWdSwOrch<DropHandler, ForwardHandler>::pollQueues(uint32_t nearestTime,
             {
                 throw runtime_error("Invalid PFC WD Action");
             }
-
-            queueEntry.pollTimeLeft = queueEntry.c_restorationTime;
         }
         // Queue is restored
-        else if (restoreCheckReply.find(queueIdStr) != restoreCheckReply.end())
+        else if (restored[i])
         {
             queueEntry.handler = nullptr;
-            queueEntry.pollTimeLeft = queueEntry.c_detectionTime;
         }
-        // Update queue poll timer
+
+        uint32_t pollTime = queueEntry.handler == nullptr ?
+            queueEntry.c_detectionTime :
+            queueEntry.c_restorationTime;
+
+        queueEntry.nextPoll = now + chrono::milliseconds(pollTime);
+        m_pollEvents.emplace(queueEntry.nextPoll, queueId);
+    }
+
+    // Write all state changes of this round at once
+    PfcWdOrch<DropHandler, ForwardHandler>::flushWdCounters();
+}
+
+template <typename DropHandler, typename ForwardHandler>
+void PfcWdSwOrch<DropHandler, ForwardHandler>::checkQueuesLua(DBConnector& db,
+        const string& detectSha, const string& restoreSha, const vector<sai_object_id_t>& queues,
+        vector<uint8_t>& stormed, vector<uint8_t>& restored)
+{
+    SWSS_LOG_ENTER();
+
+    // Normal queues are grouped by detection time
+    // as the detection script needs the poll interval
+    map<uint32_t, vector<string>> normalQueues;
+    vector<string> stormedQueues;
+    for (sai_object_id_t queueId : queues)
+    {
+        const PfcWdQueueEntry& queueEntry = m_entryMap.at(queueId);
+
+        if (queueEntry.handler != nullptr)
+        {
+            stormedQueues.push_back(queueEntry.c_queueIdStr);
+        }
+        else
+        {
+            normalQueues[queueEntry.c_detectionTime].push_back(queueEntry.c_queueIdStr);
+        }
+    }
+
+    set<string> stormCheckReply;
+    set<string> restoreCheckReply;
+
+    for (const auto& group : normalQueues)
+    {
+        vector<string> argv =
+        {
+            to_string(COUNTERS_DB),
+            COUNTERS_TABLE,
+            to_string(group.first * 1000)
+        };
+
+        auto reply = runRedisScript(db, detectSha, group.second, argv);
+        stormCheckReply.insert(reply.begin(), reply.end());
+    }
+
+    if (!stormedQueues.empty())
+    {
+        vector<string> argv =
+        {
+            to_string(COUNTERS_DB),
+            COUNTERS_TABLE
+        };
+
+        restoreCheckReply = runRedisScript(db, restoreSha, stormedQueues, argv);
+    }
+
+    stormed.assign(queues.size(), 0);
+    restored.assign(queues.size(), 0);
+
+    for (size_t i = 0; i < queues.size(); i++)
+    {
+        const string& queueIdStr = m_entryMap.at(queues[i]).c_queueIdStr;
+
+        stormed[i] = stormCheckReply.find(queueIdStr) != stormCheckReply.end();
+        restored[i] = restoreCheckReply.find(queueIdStr) != restoreCheckReply.end();
+    }
+}
+
+template <typename DropHandler, typename ForwardHandler>
+void PfcWdSwOrch<DropHandler, ForwardHandler>::checkQueuesNative(DBConnector& db,
+        const vector<sai_object_id_t>& queues, vector<uint8_t>& stormed, vector<uint8_t>& restored)
+{
+    SWSS_LOG_ENTER();
+
+    size_t count = queues.size();
+
+    PfcWdCounterBatch batch;
+    batch.resize(count);
+
+    readCounters(db, queues, batch);
+
+    detectStorms(batch, stormed);
+
+    // Queue is restored if no PFC frames were received since the last poll
+    restored.assign(count, 0);
+    for (size_t i = 0; i < count; i++)
+    {
+        restored[i] = batch.pfcRxValid[i] &
+            (batch.pfcRxPackets[i] == batch.pfcRxPacketsLast[i]) &
+            !batch.debugStorm[i];
+    }
+
+    // Only keep the check matching the queue state and save the snapshot
+    for (size_t i = 0; i < count; i++)
+    {
+        PfcWdQueueEntry& queueEntry = m_entryMap.at(queues[i]);
+
+        if (queueEntry.handler == nullptr)
+        {
+            restored[i] = 0;
+
+            if (batch.present[i])
+            {
+                queueEntry.packetsLast = batch.packets[i];
+                queueEntry.pfcRxPacketsLast = batch.pfcRxPackets[i];
+                queueEntry.pfcDurationLast = batch.pfcDuration[i];
+                // Duration is accumulated from scratch after a storm
+                queueEntry.lastValid = !stormed[i];
+                queueEntry.lastPfcRxValid = true;
+            }
+        }
         else
         {
-            queueEntry.pollTimeLeft = queueEntry.pollTimeLeft == nearestTime ?
-                (queueEntry.handler == nullptr ?
-                 queueEntry.c_detectionTime :
-                 queueEntry.c_restorationTime) :
-                queueEntry.pollTimeLeft - nearestTime;
+            stormed[i] = 0;
+
+            if (batch.pfcRxPresent[i])
+            {
+                queueEntry.pfcRxPacketsLast = batch.pfcRxPackets[i];
+                queueEntry.lastPfcRxValid = true;
+            }
         }
     }
 }
 
+template <typename DropHandler, typename ForwardHandler>
+void PfcWdSwOrch<DropHandler, ForwardHandler>::readCounters(DBConnector& db,
+        const vector<sai_object_id_t>& queues, PfcWdCounterBatch& batch)
+{
+    SWSS_LOG_ENTER();
+
+    static const string occupancyField = sai_serialize_queue_stat(SAI_QUEUE_STAT_CURR_OCCUPANCY_BYTES);
+    static const string packetsField = sai_serialize_queue_stat(SAI_QUEUE_STAT_PACKETS);
+
+    redisContext *ctx = db.getContext();
+
+    // Queue all reads first, then collect the replies in one round trip
+    for (sai_object_id_t queueId : queues)
+    {
+        const PfcWdQueueEntry& queueEntry = m_entryMap.at(queueId);
+        string key = string(COUNTERS_TABLE) + ":" + queueEntry.c_queueIdStr;
+
+        if (redisAppendCommand(ctx, "HMGET %s %s %s %s %s %s",
+                    key.c_str(),
+                    occupancyField.c_str(),
+                    packetsField.c_str(),
+                    queueEntry.c_pfcRxPacketsField.c_str(),
+                    queueEntry.c_pfcDurationField.c_str(),
+                    PFC_WD_DEBUG_STORM) != REDIS_OK)
+        {
+            throw runtime_error("Failed to queue PFC Watchdog counters read");
+        }
+    }
+
+    for (size_t i = 0; i < queues.size(); i++)
+    {
+        const PfcWdQueueEntry& queueEntry = m_entryMap.at(queues[i]);
+
+        redisReply *reply = nullptr;
+        if (redisGetReply(ctx, reinterpret_cast<void **>(&reply)) != REDIS_OK || reply == nullptr)
+        {
+            throw runtime_error("Failed to read PFC Watchdog counters");
+        }
+
+        if (reply->type == REDIS_REPLY_ARRAY && reply->elements == 5)
+        {
+            bool present = getCounterValue(reply->element[0], batch.occupancyBytes[i]);
+            present &= getCounterValue(reply->element[1], batch.packets[i]);
+            bool pfcRxPresent = getCounterValue(reply->element[2], batch.pfcRxPackets[i]);
+            present &= pfcRxPresent;
+            present &= getCounterValue(reply->element[3], batch.pfcDuration[i]);
+
+            batch.present[i] = present;
+            batch.pfcRxPresent[i] = pfcRxPresent;
+            batch.debugStorm[i] = reply->element[4]->type == REDIS_REPLY_STRING &&
+                string(reply->element[4]->str, reply->element[4]->len) == PFC_WD_DEBUG_STORM_ENABLED;
+        }
+
+        freeReplyObject(reply);
+
+        batch.packetsLast[i] = queueEntry.packetsLast;
+        batch.pfcRxPacketsLast[i] = queueEntry.pfcRxPacketsLast;
+        batch.pfcDurationLast[i] = queueEntry.pfcDurationLast;
+        batch.pollTime[i] = queueEntry.c_detectionTime * 1000ULL;
+        batch.valid[i] = batch.present[i] && queueEntry.lastValid;
+        batch.pfcRxValid[i] = batch.pfcRxPresent[i] && queueEntry.lastPfcRxValid;
+    }
+}
+
 template <typename DropHandler, typename ForwardHandler>
 void PfcWdSwOrch<DropHandler, ForwardHandler>::pfcWatchdogThread(void)
 {
     DBConnector db(COUNTERS_DB, DBConnector::DEFAULT_UNIXSOCKET, 0);
 
-    // Load script for storm detection
-    string detectScriptName = getStormDetectionCriteria();
-    string detectLuaScript = loadLuaScript(detectScriptName);
-    string detectSha = loadRedisScript(&db, detectLuaScript);
+    string detectSha;
+    string restoreSha;
 
-    // Load script for restoration check
-    string restoreLuaScript = loadLuaScript("pfc_restore_check.lua");
-    string restoreSha = loadRedisScript(&db, restoreLuaScript);
+    // Scripts are only needed in compatibility mode
+    if (gPfcWdLuaDetection)
+    {
+        // Load script for storm detection
+        string detectScriptName = getStormDetectionCriteria();
+        string detectLuaScript = loadLuaScript(detectScriptName);
+        detectSha = loadRedisScript(&db, detectLuaScript);
+
+        // Load script for restoration check
+        string restoreLuaScript = loadLuaScript("pfc_restore_check.lua");
+        restoreSha = loadRedisScript(&db, restoreLuaScript);
+    }
 
     while(m_runPfcWdSwOrchThread)
     {
         unique_lock<mutex> lk(m_mtxSleep);
 
-        uint32_t sleepTime = getNearestPollTime();
+        auto nextPoll = getNearestPollTime();
 
-        m_cvSleep.wait_for(lk, chrono::milliseconds(sleepTime));
+        m_cvSleep.wait_until(lk, nextPoll);
 
-        pollQueues(sleepTime, db, detectSha, restoreSha);
+        pollQueues(db, detectSha, restoreSha);
     }
 }
 
@@ -679,30 +961,6 @@ vector<sai_port_stat_t> PfcDurationWatchdog<DropHandler, ForwardHandler>::getPor
 {
     SWSS_LOG_ENTER();
 
-    static const vector<sai_port_stat_t> PfcDurationIdMap =
-    {
-        SAI_PORT_STAT_PFC_0_RX_PAUSE_DURATION,
-        SAI_PORT_STAT_PFC_1_RX_PAUSE_DURATION,
-        SAI_PORT_STAT_PFC_2_RX_PAUSE_DURATION,
-        SAI_PORT_STAT_PFC_3_RX_PAUSE_DURATION,
-        SAI_PORT_STAT_PFC_4_RX_PAUSE_DURATION,
-        SAI_PORT_STAT_PFC_5_RX_PAUSE_DURATION,
-        SAI_PORT_STAT_PFC_6_RX_PAUSE_DURATION,
-        SAI_PORT_STAT_PFC_7_RX_PAUSE_DURATION,
-    };
-
-    static const vector<sai_port_stat_t> PfcRxPktsIdMap =
-    {
-        SAI_PORT_STAT_PFC_0_RX_PKTS,
-        SAI_PORT_STAT_PFC_1_RX_PKTS,
-        SAI_PORT_STAT_PFC_2_RX_PKTS,
-        SAI_PORT_STAT_PFC_3_RX_PKTS,
-        SAI_PORT_STAT_PFC_4_RX_PKTS,
-        SAI_PORT_STAT_PFC_5_RX_PKTS,
-        SAI_PORT_STAT_PFC_6_RX_PKTS,
-        SAI_PORT_STAT_PFC_7_RX_PKTS,
-    };
-
     sai_attribute_t attr;
     attr.id = SAI_QUEUE_ATTR_INDEX;
 
@@ -751,5 +1009,31 @@ string PfcDurationWatchdog<DropHandler, ForwardHandler>::getStormDetectionCriter
     return "duration_criteria.lua";
 }
 
+template <typename DropHandler, typename ForwardHandler>
+void PfcDurationWatchdog<DropHandler, ForwardHandler>::detectStorms(
+        const PfcWdCounterBatch& batch, vector<uint8_t>& stormed)
+{
+    SWSS_LOG_ENTER();
+
+    size_t count = batch.valid.size();
+    stormed.assign(count, 0);
+
+    // Same criteria as duration_criteria.lua. Queue is stormed if it
+    // transmitted nothing since the last poll and either has data queued
+    // while receiving PFC frames, or is empty but was paused for more
+    // than 80% of the poll interval.
+    for (size_t i = 0; i < count; i++)
+    {
+        uint8_t noTx = batch.packets[i] == batch.packetsLast[i];
+        uint8_t pfcRx = batch.pfcRxPackets[i] > batch.pfcRxPacketsLast[i];
+        uint8_t paused = batch.pfcDuration[i] > batch.pfcDurationLast[i] &&
+            (batch.pfcDuration[i] - batch.pfcDurationLast[i]) * 5 > batch.pollTime[i] * 4;
+        uint8_t occupied = batch.occupancyBytes[i] > 0;
+
+        stormed[i] = batch.valid[i] &
+            ((noTx & ((occupied & pfcRx) | (!occupied & paused))) | batch.debugStorm[i]);
+    }
+}
+
 // Trick to keep member functions in a separate file
 template class PfcDurationWatchdog<PfcWdZeroBufferHandler, PfcWdLossyHandler>;
@@ -2,11 +2,14 @@
 #define PFC_WATCHDOG_H
 
 #include <mutex>
+#include <queue>
+#include <chrono>
 #include <condition_variable>
 #include "orch.h"
 #include "port.h"
 #include "pfcactionhandler.h"
 #include "producerstatetable.h"
+#include "redispipeline.h"
 
 extern "C" {
 #include "sai.h"
@@ -43,6 +46,10 @@ public:
         return m_countersTable;;
     }
 
+protected:
+    // Publish the pending watchdog stats and storm history
+    void flushWdCounters(void);
+
 private:
     template <typename T>
     static string counterIdsToStr(const vector<T> ids, string (*convert)(T));
@@ -56,6 +63,36 @@ private:
     shared_ptr<DBConnector> m_countersDb = nullptr;
     shared_ptr<ProducerStateTable> m_pfcWdTable = nullptr;
     shared_ptr<Table> m_countersTable = nullptr;
+    // Written from the poller thread and the orch thread, only with the
+    // handlers' lock held
+    shared_ptr<DBConnector> m_wdCountersDb = nullptr;
+    shared_ptr<RedisPipeline> m_wdCountersPipeline = nullptr;
+    shared_ptr<Table> m_wdCountersTable = nullptr;
+    shared_ptr<Table> m_stormHistoryTable = nullptr;
+};
+
+// Counters of the queues polled in one round, one element per queue in
+// every array, so that the criteria can be evaluated in a single pass.
+struct PfcWdCounterBatch
+{
+    void resize(size_t size);
+
+    vector<uint64_t> occupancyBytes;
+    vector<uint64_t> packets;
+    vector<uint64_t> packetsLast;
+    vector<uint64_t> pfcRxPackets;
+    vector<uint64_t> pfcRxPacketsLast;
+    vector<uint64_t> pfcDuration;
+    vector<uint64_t> pfcDurationLast;
+    // Poll interval in microseconds
+    vector<uint64_t> pollTime;
+    // All counters were read in this round
+    vector<uint8_t> present;
+    // Counters were read and the previous snapshot exists
+    vector<uint8_t> valid;
+    vector<uint8_t> pfcRxPresent;
+    vector<uint8_t> pfcRxValid;
+    vector<uint8_t> debugStorm;
 };
 
 template <typename DropHandler, typename ForwardHandler>
@@ -65,7 +102,10 @@ public:
     PfcWdSwOrch(DBConnector *db, vector<string> &tableNames);
     virtual ~PfcWdSwOrch(void);
 
+    // Lua script used for detection in compatibility mode
     virtual string getStormDetectionCriteria(void) = 0;
+    // Native detection, sets stormed[i] for each queue of the batch
+    virtual void detectStorms(const PfcWdCounterBatch& batch, vector<uint8_t>& stormed) = 0;
 
     virtual bool startWdOnPort(const Port& port,
             uint32_t detectionTime, uint32_t restorationTime, PfcWdAction action);
@@ -76,29 +116,54 @@ private:
     struct PfcWdQueueEntry
     {
         PfcWdQueueEntry(uint32_t detectionTime, uint32_t restorationTime,
-                PfcWdAction action, sai_object_id_t port, uint8_t idx);
+                PfcWdAction action, sai_object_id_t port, uint8_t idx,
+                const string& queueIdStr);
 
         const uint32_t c_detectionTime = 0;
         const uint32_t c_restorationTime = 0;
         const PfcWdAction c_action = PfcWdAction::PFC_WD_ACTION_UNKNOWN;
 
         sai_object_id_t portId = SAI_NULL_OBJECT_ID;
-        // Remaining time till the next poll
-        uint32_t pollTimeLeft = 0;
+        // Serialized queue ID, passed to the scripts as COUNTERS_DB key
+        const string c_queueIdStr;
+        // Deadline of the next poll
+        chrono::steady_clock::time_point nextPoll;
         uint8_t index = 0;
         shared_ptr<PfcWdActionHandler> handler = { nullptr };
+
+        // Port counters of the queue priority
+        const string c_pfcRxPacketsField;
+        const string c_pfcDurationField;
+
+        // Counter snapshot of the previous native poll
+        bool lastValid = false;
+        bool lastPfcRxValid = false;
+        uint64_t packetsLast = 0;
+        uint64_t pfcRxPacketsLast = 0;
+        uint64_t pfcDurationLast = 0;
     };
 
+    // Poll deadline and queue ID, ordered by deadline
+    typedef pair<chrono::steady_clock::time_point, sai_object_id_t> PfcWdPollEvent;
+
     bool startWdOnQueue(sai_object_id_t queueId, uint8_t idx, sai_object_id_t portId,
             uint32_t detectionTime, uint32_t restorationTime, PfcWdAction action);
     bool stopWdOnQueue(sai_object_id_t queueId);
-    uint32_t getNearestPollTime(void);
-    void pollQueues(uint32_t nearestTime, DBConnector& db, string detectSha, string restoreSha);
+    chrono::steady_clock::time_point getNearestPollTime(void);
+    void pollQueues(DBConnector& db, const string& detectSha, const string& restoreSha);
+    void checkQueuesLua(DBConnector& db, const string& detectSha, const string& restoreSha,
+            const vector<sai_object_id_t>& queues, vector<uint8_t>& stormed, vector<uint8_t>& restored);
+    void checkQueuesNative(DBConnector& db, const vector<sai_object_id_t>& queues,
+            vector<uint8_t>& stormed, vector<uint8_t>& restored);
+    void readCounters(DBConnector& db, const vector<sai_object_id_t>& queues, PfcWdCounterBatch& batch);
     void pfcWatchdogThread(void);
     void startWatchdogThread(void);
     void endWatchdogThread(void);
 
     map<sai_object_id_t, PfcWdQueueEntry> m_entryMap;
+    // Min-heap of pending polls. Events of stopped or rescheduled
+    // queues are not removed, they are dropped when they reach the top.
+    priority_queue<PfcWdPollEvent, vector<PfcWdPollEvent>, greater<PfcWdPollEvent>> m_pollEvents;
     mutex m_pfcWdMutex;
 
     atomic_bool m_runPfcWdSwOrchThread = { false };
@@ -117,6 +182,7 @@ public:
     virtual vector<sai_port_stat_t> getPortCounterIds(sai_object_id_t queueId);
     virtual vector<sai_queue_stat_t> getQueueCounterIds(sai_object_id_t queueId);
     virtual string getStormDetectionCriteria(void);
+    virtual void detectStorms(const PfcWdCounterBatch& batch, vector<uint8_t>& stormed);
 };
 
 #endif
@@ -63,6 +63,7 @@ public:
     sai_object_id_t     m_hif_id = 0;
     sai_object_id_t     m_lag_id = 0;
     sai_object_id_t     m_lag_member_id = 0;
+    bool                m_lag_member_egress_disabled = false;  // LAG member egress disabled on oper down until teamd reconciles
     sai_object_id_t     m_acl_table_group_id = 0;
     std::set<std::string> m_members;
     std::vector<sai_object_id_t> m_queue_ids;
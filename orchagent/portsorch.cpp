@@ -5,6 +5,7 @@
 #include <sstream>
 #include <set>
 #include <algorithm>
+#include <chrono>
 
 #include <netinet/if_ether.h>
 #include "net/if.h"
@@ -30,7 +31,7 @@ extern sai_object_id_t gSwitchId;
  *    VLAN. All ports are in .1Q bridge as bridge ports, and all bridge ports
  *    are in default VLAN as VLAN members.
  * 1) Query switch CPU port.
- * 2) Query ports associated with lane mappings
+ * 2) Query ports associated with lane mappings, queues and priority groups
  * 3) Query switch .1Q bridge and all its bridge ports.
  * 4) Query switch default VLAN and all its VLAN members.
  * 5) Remove each VLAN member from default VLAN and each bridge port from .1Q
@@ -49,7 +50,10 @@ PortsOrch::PortsOrch(DBConnector *db, vector<string> tableNames) :
     /* Initialize port table */
     m_portTable = unique_ptr<Table>(new Table(m_db, APP_PORT_TABLE_NAME));
 
-    uint32_t i, j;
+    /* Last LAG member status published by teamsyncd */
+    m_lagMemberTable = unique_ptr<Table>(new Table(m_db, APP_LAG_MEMBER_TABLE_NAME));
+
+    uint32_t i;
     sai_status_t status;
     sai_attribute_t attr;
 
@@ -95,24 +99,17 @@ PortsOrch::PortsOrch(DBConnector *db, vector<string> tableNames) :
         throw "PortsOrch initialization failure";
     }
 
-    /* Get port hardware lane info */
+    /*
+     * Get port hardware lane info together with the queues and priority groups
+     * of every port. Discovery is done here so that port initialization on
+     * PORT_TABLE entries only issues create and set calls.
+     */
+    auto discoveryStart = chrono::steady_clock::now();
+
     for (i = 0; i < m_portCount; i++)
     {
-        sai_uint32_t lanes[4] = { 0,0,0,0 };
-        attr.id = SAI_PORT_ATTR_HW_LANE_LIST;
-        attr.value.u32list.count = 4;
-        attr.value.u32list.list = lanes;
-
-        status = sai_port_api->get_port_attribute(port_list[i], 1, &attr);
-        if (status != SAI_STATUS_SUCCESS)
-        {
-            SWSS_LOG_ERROR("Failed to get hardware lane list pid:%lx", port_list[i]);
-            throw "PortsOrch initialization failure";
-        }
-
         set<int> tmp_lane_set;
-        for (j = 0; j < attr.value.u32list.count; j++)
-            tmp_lane_set.insert(attr.value.u32list.list[j]);
+        discoverPort(port_list[i], tmp_lane_set);
 
         string tmp_lane_str = "";
         for (auto s : tmp_lane_set)
@@ -125,6 +122,9 @@ PortsOrch::PortsOrch(DBConnector *db, vector<string> tableNames) :
         m_portListLaneMap[tmp_lane_set] = port_list[i];
     }
 
+    chrono::duration<double, milli> discoveryTime = chrono::steady_clock::now() - discoveryStart;
+    SWSS_LOG_NOTICE("Discovered %d ports in %.1f ms", m_portCount, discoveryTime.count());
+
     /* Get default 1Q bridge and default VLAN */
     vector<sai_attribute_t> attrs;
     attr.id = SAI_SWITCH_ATTR_DEFAULT_1Q_BRIDGE_ID;
@@ -235,41 +235,33 @@ map<string, Port>& PortsOrch::getAllPorts()
     return m_portList;
 }
 
-bool PortsOrch::getPort(string alias, Port &p)
+Port *PortsOrch::findPort(const string &alias)
 {
-    SWSS_LOG_ENTER();
-
-    if (m_portList.find(alias) == m_portList.end())
-    {
-        return false;
-    }
-    else
+    auto it = m_portList.find(alias);
+    if (it == m_portList.end())
     {
-        p = m_portList[alias];
-        return true;
+        return NULL;
     }
+
+    return &it->second;
 }
 
-bool PortsOrch::getPort(sai_object_id_t id, Port &port)
+Port *PortsOrch::findPort(sai_object_id_t id)
 {
-    SWSS_LOG_ENTER();
-
-    for (const auto& portIter: m_portList)
+    for (auto &portIter: m_portList)
     {
         switch (portIter.second.m_type)
         {
         case Port::PHY:
             if(portIter.second.m_port_id == id)
             {
-                port = portIter.second;
-                return true;
+                return &portIter.second;
             }
             break;
         case Port::LAG:
             if(portIter.second.m_lag_id == id)
             {
-                port = portIter.second;
-                return true;
+                return &portIter.second;
             }
             break;
         default:
@@ -277,28 +269,62 @@ bool PortsOrch::getPort(sai_object_id_t id, Port &port)
         }
     }
 
-    return false;
+    return NULL;
 }
 
-bool PortsOrch::getPortByBridgePortId(sai_object_id_t bridge_port_id, Port &port)
+Port *PortsOrch::findPortByBridgePortId(sai_object_id_t bridge_port_id)
 {
-    SWSS_LOG_ENTER();
-
     for (auto &it: m_portList)
     {
         if (it.second.m_bridge_port_id == bridge_port_id)
         {
-            port = it.second;
-            return true;
+            return &it.second;
         }
     }
 
-    return false;
+    return NULL;
+}
+
+bool PortsOrch::getPort(string alias, Port &p)
+{
+    SWSS_LOG_ENTER();
+
+    Port *port = findPort(alias);
+    if (!port)
+    {
+        return false;
+    }
+
+    p = *port;
+    return true;
+}
+
+bool PortsOrch::getPort(sai_object_id_t id, Port &port)
+{
+    SWSS_LOG_ENTER();
+
+    Port *p = findPort(id);
+    if (!p)
+    {
+        return false;
+    }
+
+    port = *p;
+    return true;
 }
 
-void PortsOrch::setPort(string alias, Port p)
+bool PortsOrch::getPortByBridgePortId(sai_object_id_t bridge_port_id, Port &port)
 {
-    m_portList[alias] = p;
+    SWSS_LOG_ENTER();
+
+    Port *p = findPortByBridgePortId(bridge_port_id);
+    if (!p)
+    {
+        return false;
+    }
+
+    port = *p;
+    return true;
 }
 
 void PortsOrch::getCpuPort(Port &port)
@@ -470,6 +496,70 @@ void PortsOrch::updateDbPortOperStatus(sai_object_id_t id, sai_port_oper_status_
     }
 }
 
+/*
+ * Fast LAG failover: stop hashing traffic to a LAG member as soon as its port
+ * goes down instead of waiting for teamd to remove the member through
+ * LAG_MEMBER_TABLE. Egress is only turned back on by the "enabled" status of
+ * teamd in doLagMemberTask, never by the port coming back up.
+ */
+void PortsOrch::updateLagMemberEgress(sai_object_id_t id, bool up)
+{
+    SWSS_LOG_ENTER();
+
+    Port *port = findPort(id);
+    if (!port || port->m_type != Port::PHY || !port->m_lag_member_id)
+    {
+        return;
+    }
+
+    if (!up)
+    {
+        if (!port->m_lag_member_egress_disabled)
+        {
+            setLagMemberEgress(*port, false);
+        }
+        return;
+    }
+
+    if (!port->m_lag_member_egress_disabled)
+    {
+        return;
+    }
+
+    Port *lag = findPort(port->m_lag_id);
+    auto consumer_it = m_consumerMap.find(APP_LAG_MEMBER_TABLE_NAME);
+    if (!lag || consumer_it == m_consumerMap.end())
+    {
+        return;
+    }
+
+    Consumer &consumer = consumer_it->second;
+    string key = lag->m_alias + ":" + port->m_alias;
+
+    /* A status change of teamd is pending and reconciles the member */
+    if (consumer.m_toSync.find(key) != consumer.m_toSync.end())
+    {
+        return;
+    }
+
+    /*
+     * The flap was shorter than teamd takes to disable the member, so no
+     * status change will come. Reconcile with the last status teamd
+     * published: "enabled" turns egress back on, "disabled" removes the
+     * member.
+     */
+    vector<FieldValueTuple> fvs;
+    if (!m_lagMemberTable->get(key, fvs))
+    {
+        return;
+    }
+
+    SWSS_LOG_NOTICE("Reconcile LAG member %s with teamd after a short flap", key.c_str());
+
+    consumer.m_toSync[key] = KeyOpFieldsValuesTuple(key, SET_COMMAND, fvs);
+    doLagMemberTask(consumer);
+}
+
 void PortsOrch::doPortTask(Consumer &consumer)
 {
     SWSS_LOG_ENTER();
@@ -497,6 +587,9 @@ void PortsOrch::doPortTask(Consumer &consumer)
             {
                 m_initDone = true;
                 SWSS_LOG_INFO("Get ConfigDone notification from portsyncd.");
+                SWSS_LOG_NOTICE("Initialized %zu ports in %.1f ms, slowest port %s %.1f ms",
+                        m_portInitCount, m_portInitTime.count(),
+                        m_portInitSlowest.c_str(), m_portInitSlowestTime.count());
             }
 
             it = consumer.m_toSync.erase(it);
@@ -548,7 +641,8 @@ void PortsOrch::doPortTask(Consumer &consumer)
                     sai_object_id_t id = m_portListLaneMap[lane_set];
 
                     /* Determin if the port has already been initialized before */
-                    if (m_portList.find(alias) != m_portList.end() && m_portList[alias].m_port_id == id)
+                    auto existing = m_portList.find(alias);
+                    if (existing != m_portList.end() && existing->second.m_port_id == id)
                     {
                         SWSS_LOG_INFO("Port has already been initialized before alias:%s", alias.c_str());
                     }
@@ -582,8 +676,8 @@ void PortsOrch::doPortTask(Consumer &consumer)
                     SWSS_LOG_ERROR("Failed to locate port lane combination alias:%s", alias.c_str());
             }
 
-            Port p;
-            if (!getPort(alias, p))
+            Port *p = findPort(alias);
+            if (!p)
             {
                 SWSS_LOG_ERROR("Failed to get port id by alias:%s", alias.c_str());
             }
@@ -593,20 +687,20 @@ void PortsOrch::doPortTask(Consumer &consumer)
                 {
                     sai_uint32_t current_speed;
 
-                    if (!validatePortSpeed(p.m_port_id, speed))
+                    if (!validatePortSpeed(p->m_port_id, speed))
                     {
                         SWSS_LOG_ERROR("Failed to set speed %u for port %s. The value is not supported", speed, alias.c_str());
                         it++;
                         continue;
                     }
 
-                    if (getPortSpeed(p.m_port_id, current_speed))
+                    if (getPortSpeed(p->m_port_id, current_speed))
                     {
                         if (speed != current_speed)
                         {
-                            if(setPortAdminStatus(p.m_port_id, false))
+                            if(setPortAdminStatus(p->m_port_id, false))
                             {
-                                if (setPortSpeed(p.m_port_id, speed))
+                                if (setPortSpeed(p->m_port_id, speed))
                                 {
                                     SWSS_LOG_NOTICE("Set port %s speed to %u", alias.c_str(), speed);
                                 }
@@ -632,7 +726,7 @@ void PortsOrch::doPortTask(Consumer &consumer)
 
                 if (admin_status != "")
                 {
-                    if (setPortAdminStatus(p.m_port_id, admin_status == "up"))
+                    if (setPortAdminStatus(p->m_port_id, admin_status == "up"))
                         SWSS_LOG_NOTICE("Set port %s admin status to %s", alias.c_str(), admin_status.c_str());
                     else
                     {
@@ -644,7 +738,7 @@ void PortsOrch::doPortTask(Consumer &consumer)
 
                 if (mtu != 0)
                 {
-                    if (setPortMtu(p.m_port_id, mtu))
+                    if (setPortMtu(p->m_port_id, mtu))
                         SWSS_LOG_NOTICE("Set port %s MTU to %u", alias.c_str(), mtu);
                     else
                     {
@@ -721,11 +815,20 @@ void PortsOrch::doVlanTask(Consumer &consumer)
     }
 }
 
+/*
+ * VLAN members are validated first and then programmed in bulk: all removals
+ * of the batch with one call, then all additions with one call. A port can be
+ * queued only once per batch; further entries for it are retried next time.
+ */
 void PortsOrch::doVlanMemberTask(Consumer &consumer)
 {
     if (!isInitDone())
         return;
 
+    vector<VlanMemberRequest> add_requests;
+    vector<VlanMemberRequest> remove_requests;
+    set<string> queued_ports;
+
     auto it = consumer.m_toSync.begin();
     while (it != consumer.m_toSync.end())
     {
@@ -761,18 +864,17 @@ void PortsOrch::doVlanMemberTask(Consumer &consumer)
         vlan_alias = VLAN_PREFIX + to_string(vlan_id);
         string op = kfvOp(t);
 
-        assert(m_portList.find(vlan_alias) != m_portList.end());
-        Port vlan, port;
-
         /* When VLAN member is to be created before VLAN is created */
-        if (!getPort(vlan_alias, vlan))
+        auto vlan = m_portList.find(vlan_alias);
+        if (vlan == m_portList.end())
         {
             SWSS_LOG_INFO("Failed to locate VLAN %s", vlan_alias.c_str());
             it++;
             continue;
         }
 
-        if (!getPort(port_alias, port))
+        auto port = m_portList.find(port_alias);
+        if (port == m_portList.end())
         {
             SWSS_LOG_ERROR("Failed to locate port %s", port_alias.c_str());
             it = consumer.m_toSync.erase(it);
@@ -789,9 +891,14 @@ void PortsOrch::doVlanMemberTask(Consumer &consumer)
                     tagging_mode = fvValue(i);
             }
 
-            if (tagging_mode != "untagged" &&
-                tagging_mode != "tagged"   &&
-                tagging_mode != "priority_tagged")
+            sai_vlan_tagging_mode_t sai_tagging_mode;
+            if (tagging_mode == "untagged")
+                sai_tagging_mode = SAI_VLAN_TAGGING_MODE_UNTAGGED;
+            else if (tagging_mode == "tagged")
+                sai_tagging_mode = SAI_VLAN_TAGGING_MODE_TAGGED;
+            else if (tagging_mode == "priority_tagged")
+                sai_tagging_mode = SAI_VLAN_TAGGING_MODE_PRIORITY_TAGGED;
+            else
             {
                 SWSS_LOG_ERROR("Wrong tagging_mode '%s' for key: %s", tagging_mode.c_str(), kfvKey(t).c_str());
                 it = consumer.m_toSync.erase(it);
@@ -799,41 +906,62 @@ void PortsOrch::doVlanMemberTask(Consumer &consumer)
             }
 
             /* Duplicate entry */
-            if (vlan.m_members.find(port_alias) != vlan.m_members.end())
+            if (vlan->second.m_members.find(port_alias) != vlan->second.m_members.end())
             {
                 it = consumer.m_toSync.erase(it);
                 continue;
             }
 
-            /* Assert the port doesn't belong to any VLAN */
-            assert(!port.m_vlan_id && !port.m_vlan_member_id);
-
-            if (addBridgePort(port) && addVlanMember(vlan, port, tagging_mode))
-                it = consumer.m_toSync.erase(it);
-            else
+            /* The port leaves its VLAN in this batch or is already queued */
+            if (port->second.m_vlan_member_id || queued_ports.find(port_alias) != queued_ports.end())
+            {
                 it++;
+                continue;
+            }
+
+            queued_ports.insert(port_alias);
+            add_requests.push_back({ it, &vlan->second, &port->second, sai_tagging_mode, false });
         }
         else if (op == DEL_COMMAND)
         {
-            if (vlan.m_members.find(port_alias) != vlan.m_members.end())
+            if (vlan->second.m_members.find(port_alias) != vlan->second.m_members.end())
             {
                 /* Assert the port belongs the a VLAN */
-                assert(port.m_vlan_id && port.m_vlan_member_id);
+                assert(port->second.m_vlan_id && port->second.m_vlan_member_id);
 
-                if (removeVlanMember(vlan, port))
-                    it = consumer.m_toSync.erase(it);
-                else
-                    it++;
+                remove_requests.push_back({ it, &vlan->second, &port->second, SAI_VLAN_TAGGING_MODE_UNTAGGED, false });
             }
             else
+            {
                 /* Cannot locate the VLAN */
                 it = consumer.m_toSync.erase(it);
+                continue;
+            }
         }
         else
         {
             SWSS_LOG_ERROR("Unknown operation type %s", op.c_str());
             it = consumer.m_toSync.erase(it);
+            continue;
         }
+
+        it++;
+    }
+
+    removeVlanMembers(remove_requests);
+
+    for (auto &request : remove_requests)
+    {
+        if (request.done)
+            consumer.m_toSync.erase(request.task);
+    }
+
+    addVlanMembers(add_requests);
+
+    for (auto &request : add_requests)
+    {
+        if (request.done)
+            consumer.m_toSync.erase(request.task);
     }
 }
 
@@ -911,15 +1039,16 @@ void PortsOrch::doLagMemberTask(Consumer &consumer)
 
         string op = kfvOp(t);
 
-        Port lag, port;
-        if (!getPort(lag_alias, lag))
+        Port *lag = findPort(lag_alias);
+        if (!lag)
         {
             SWSS_LOG_INFO("Failed to locate LAG %s", lag_alias.c_str());
             it++;
             continue;
         }
 
-        if (!getPort(port_alias, port))
+        Port *port = findPort(port_alias);
+        if (!port)
         {
             SWSS_LOG_ERROR("Failed to locate port %s", port_alias.c_str());
             it = consumer.m_toSync.erase(it);
@@ -940,16 +1069,23 @@ void PortsOrch::doLagMemberTask(Consumer &consumer)
             if (status == "enabled")
             {
                 /* Duplicate entry */
-                if (lag.m_members.find(port_alias) != lag.m_members.end())
+                if (lag->m_members.find(port_alias) != lag->m_members.end())
                 {
+                    /* teamd confirms a member disabled by fast failover */
+                    if (port->m_lag_member_egress_disabled && !setLagMemberEgress(*port, true))
+                    {
+                        it++;
+                        continue;
+                    }
+
                     it = consumer.m_toSync.erase(it);
                     continue;
                 }
 
                 /* Assert the port doesn't belong to any LAG */
-                assert(!port.m_lag_id && !port.m_lag_member_id);
+                assert(!port->m_lag_id && !port->m_lag_member_id);
 
-                if (addLagMember(lag, port))
+                if (addLagMember(*lag, *port))
                     it = consumer.m_toSync.erase(it);
                 else
                     it++;
@@ -959,13 +1095,13 @@ void PortsOrch::doLagMemberTask(Consumer &consumer)
             {
                 /* "status" is "disabled" at start when m_lag_id and
                  * m_lag_member_id are absent */
-                if (!port.m_lag_id || !port.m_lag_member_id)
+                if (!port->m_lag_id || !port->m_lag_member_id)
                 {
                     it = consumer.m_toSync.erase(it);
                     continue;
                 }
 
-                if (removeLagMember(lag, port))
+                if (removeLagMember(*lag, *port))
                     it = consumer.m_toSync.erase(it);
                 else
                     it++;
@@ -975,15 +1111,15 @@ void PortsOrch::doLagMemberTask(Consumer &consumer)
         else if (op == DEL_COMMAND)
         {
             /* Assert the LAG member exists */
-            assert(lag.m_members.find(port_alias) != lag.m_members.end());
+            assert(lag->m_members.find(port_alias) != lag->m_members.end());
 
-            if (!port.m_lag_id || !port.m_lag_member_id)
+            if (!port->m_lag_id || !port->m_lag_member_id)
             {
                 it = consumer.m_toSync.erase(it);
                 continue;
             }
 
-            if (removeLagMember(lag, port))
+            if (removeLagMember(*lag, *port))
                 it = consumer.m_toSync.erase(it);
             else
                 it++;
@@ -1014,72 +1150,65 @@ void PortsOrch::doTask(Consumer &consumer)
         doLagMemberTask(consumer);
 }
 
-void PortsOrch::initializeQueues(Port &port)
+void PortsOrch::discoverPort(sai_object_id_t id, set<int> &lane_set)
 {
     SWSS_LOG_ENTER();
 
-    sai_attribute_t attr;
-    attr.id = SAI_PORT_ATTR_QOS_NUMBER_OF_QUEUES;
-    sai_status_t status = sai_port_api->get_port_attribute(port.m_port_id, 1, &attr);
+    sai_uint32_t lanes[4] = { 0,0,0,0 };
+    sai_attribute_t attrs[3];
+
+    attrs[0].id = SAI_PORT_ATTR_HW_LANE_LIST;
+    attrs[0].value.u32list.count = 4;
+    attrs[0].value.u32list.list = lanes;
+    attrs[1].id = SAI_PORT_ATTR_QOS_NUMBER_OF_QUEUES;
+    attrs[2].id = SAI_PORT_ATTR_NUMBER_OF_INGRESS_PRIORITY_GROUPS;
+
+    sai_status_t status = sai_port_api->get_port_attribute(id, 3, attrs);
     if (status != SAI_STATUS_SUCCESS)
     {
-        SWSS_LOG_ERROR("Failed to get number of queues for port %s rv:%d", port.m_alias.c_str(), status);
-        throw runtime_error("PortsOrch initialization failure.");
+        SWSS_LOG_ERROR("Failed to get hardware lane list, number of queues and priority groups pid:%lx rv:%d", id, status);
+        throw "PortsOrch initialization failure";
     }
-    SWSS_LOG_INFO("Get %d queues for port %s", attr.value.u32, port.m_alias.c_str());
 
-    port.m_queue_ids.resize(attr.value.u32);
+    for (uint32_t j = 0; j < attrs[0].value.u32list.count; j++)
+        lane_set.insert(attrs[0].value.u32list.list[j]);
 
-    if (attr.value.u32 == 0)
-    {
-        return;
-    }
+    PortQosObjects &objects = m_portQosObjects[id];
+    objects.queue_ids.resize(attrs[1].value.u32);
+    objects.priority_group_ids.resize(attrs[2].value.u32);
+    SWSS_LOG_INFO("Get %d queues and %d priority groups pid:%lx", attrs[1].value.u32, attrs[2].value.u32, id);
 
-    attr.id = SAI_PORT_ATTR_QOS_QUEUE_LIST;
-    attr.value.objlist.count = (uint32_t)port.m_queue_ids.size();
-    attr.value.objlist.list = port.m_queue_ids.data();
+    /* Read both lists in one call, skipping the empty ones */
+    vector<sai_attribute_t> list_attrs;
+    sai_attribute_t attr;
 
-    status = sai_port_api->get_port_attribute(port.m_port_id, 1, &attr);
-    if (status != SAI_STATUS_SUCCESS)
+    if (!objects.queue_ids.empty())
     {
-        SWSS_LOG_ERROR("Failed to get queue list for port %s rv:%d", port.m_alias.c_str(), status);
-        throw runtime_error("PortsOrch initialization failure.");
+        attr.id = SAI_PORT_ATTR_QOS_QUEUE_LIST;
+        attr.value.objlist.count = (uint32_t)objects.queue_ids.size();
+        attr.value.objlist.list = objects.queue_ids.data();
+        list_attrs.push_back(attr);
     }
-    SWSS_LOG_INFO("Get queues for port %s", port.m_alias.c_str());
-}
-
-void PortsOrch::initializePriorityGroups(Port &port)
-{
-    SWSS_LOG_ENTER();
 
-    sai_attribute_t attr;
-    attr.id = SAI_PORT_ATTR_NUMBER_OF_INGRESS_PRIORITY_GROUPS;
-    sai_status_t status = sai_port_api->get_port_attribute(port.m_port_id, 1, &attr);
-    if (status != SAI_STATUS_SUCCESS)
+    if (!objects.priority_group_ids.empty())
     {
-        SWSS_LOG_ERROR("Failed to get number of priority groups for port %s rv:%d", port.m_alias.c_str(), status);
-        throw runtime_error("PortsOrch initialization failure.");
+        attr.id = SAI_PORT_ATTR_INGRESS_PRIORITY_GROUP_LIST;
+        attr.value.objlist.count = (uint32_t)objects.priority_group_ids.size();
+        attr.value.objlist.list = objects.priority_group_ids.data();
+        list_attrs.push_back(attr);
     }
-    SWSS_LOG_INFO("Get %d priority groups for port %s", attr.value.u32, port.m_alias.c_str());
 
-    port.m_priority_group_ids.resize(attr.value.u32);
-
-    if (attr.value.u32 == 0)
+    if (list_attrs.empty())
     {
         return;
     }
 
-    attr.id = SAI_PORT_ATTR_INGRESS_PRIORITY_GROUP_LIST;
-    attr.value.objlist.count = (uint32_t)port.m_priority_group_ids.size();
-    attr.value.objlist.list = port.m_priority_group_ids.data();
-
-    status = sai_port_api->get_port_attribute(port.m_port_id, 1, &attr);
+    status = sai_port_api->get_port_attribute(id, (uint32_t)list_attrs.size(), list_attrs.data());
     if (status != SAI_STATUS_SUCCESS)
     {
-        SWSS_LOG_ERROR("Fail to get priority group list for port %s rv:%d", port.m_alias.c_str(), status);
-        throw runtime_error("PortsOrch initialization failure.");
+        SWSS_LOG_ERROR("Failed to get queue and priority group lists pid:%lx rv:%d", id, status);
+        throw "PortsOrch initialization failure";
     }
-    SWSS_LOG_INFO("Get priority groups for port %s", port.m_alias.c_str());
 }
 
 bool PortsOrch::initializePort(Port &p)
@@ -1088,8 +1217,17 @@ bool PortsOrch::initializePort(Port &p)
 
     SWSS_LOG_NOTICE("Initializing port alias:%s pid:%lx", p.m_alias.c_str(), p.m_port_id);
 
-    initializePriorityGroups(p);
-    initializeQueues(p);
+    auto initStart = chrono::steady_clock::now();
+
+    /* Queues and priority groups were discovered with the port lanes */
+    auto objects = m_portQosObjects.find(p.m_port_id);
+    if (objects == m_portQosObjects.end())
+    {
+        SWSS_LOG_ERROR("Failed to get queues and priority groups for port %s", p.m_alias.c_str());
+        return false;
+    }
+    p.m_queue_ids = objects->second.queue_ids;
+    p.m_priority_group_ids = objects->second.priority_group_ids;
 
     /* Create host interface */
     addHostIntfs(p.m_port_id, p.m_alias, p.m_hif_id);
@@ -1117,6 +1255,17 @@ bool PortsOrch::initializePort(Port &p)
     vector.push_back(tuple);
     m_portTable->set(p.m_alias, vector);
 
+    chrono::duration<double, milli> initTime = chrono::steady_clock::now() - initStart;
+    SWSS_LOG_INFO("Initialized port %s in %.3f ms", p.m_alias.c_str(), initTime.count());
+
+    m_portInitCount++;
+    m_portInitTime += initTime;
+    if (initTime > m_portInitSlowestTime)
+    {
+        m_portInitSlowest = p.m_alias;
+        m_portInitSlowestTime = initTime;
+    }
+
     return true;
 }
 
@@ -1273,110 +1422,209 @@ bool PortsOrch::removeVlan(Port vlan)
     return true;
 }
 
-bool PortsOrch::addVlanMember(Port vlan, Port port, string& tagging_mode)
+/*
+ * Create the bridge ports that are missing and then all VLAN members with a
+ * single bulk call. Falls back to one SAI call per member when the bulk API
+ * is not implemented by the SAI library. Ports and VLANs are updated in place.
+ */
+void PortsOrch::addVlanMembers(vector<VlanMemberRequest> &requests)
 {
     SWSS_LOG_ENTER();
 
-    sai_attribute_t attr;
-    vector<sai_attribute_t> attrs;
+    vector<VlanMemberRequest *> pending;
+    vector<vector<sai_attribute_t>> member_attrs;
 
-    attr.id = SAI_VLAN_MEMBER_ATTR_VLAN_ID;
-    attr.value.oid = vlan.m_vlan_oid;
-    attrs.push_back(attr);
+    for (auto &request : requests)
+    {
+        Port &port = *request.port;
 
-    attr.id = SAI_VLAN_MEMBER_ATTR_BRIDGE_PORT_ID;
-    attr.value.oid = port.m_bridge_port_id;
-    attrs.push_back(attr);
+        if (!port.m_bridge_port_id && !addBridgePort(port))
+        {
+            continue;
+        }
 
-    attr.id = SAI_VLAN_MEMBER_ATTR_VLAN_TAGGING_MODE;
-    if (tagging_mode == "untagged")
-        attr.value.s32 = SAI_VLAN_TAGGING_MODE_UNTAGGED;
-    else if (tagging_mode == "tagged")
-        attr.value.s32 = SAI_VLAN_TAGGING_MODE_TAGGED;
-    else if (tagging_mode == "priority_tagged")
-        attr.value.s32 = SAI_VLAN_TAGGING_MODE_PRIORITY_TAGGED;
-    else assert(false);
-    attrs.push_back(attr);
+        sai_attribute_t attr;
+        vector<sai_attribute_t> attrs;
 
-    sai_object_id_t vlan_member_id;
-    sai_status_t status = sai_vlan_api->create_vlan_member(&vlan_member_id, gSwitchId, (uint32_t)attrs.size(), attrs.data());
-    if (status != SAI_STATUS_SUCCESS)
+        attr.id = SAI_VLAN_MEMBER_ATTR_VLAN_ID;
+        attr.value.oid = request.vlan->m_vlan_oid;
+        attrs.push_back(attr);
+
+        attr.id = SAI_VLAN_MEMBER_ATTR_BRIDGE_PORT_ID;
+        attr.value.oid = port.m_bridge_port_id;
+        attrs.push_back(attr);
+
+        attr.id = SAI_VLAN_MEMBER_ATTR_VLAN_TAGGING_MODE;
+        attr.value.s32 = request.tagging_mode;
+        attrs.push_back(attr);
+
+        pending.push_back(&request);
+        member_attrs.push_back(attrs);
+    }
+
+    if (pending.empty())
     {
-        SWSS_LOG_ERROR("Failed to add member %s to VLAN %s vid:%hu pid:%lx",
-                port.m_alias.c_str(), vlan.m_alias.c_str(), vlan.m_vlan_id, port.m_port_id);
-        return false;
+        return;
     }
-    SWSS_LOG_NOTICE("Add member %s to VLAN %s vid:%hu pid%lx",
-            port.m_alias.c_str(), vlan.m_alias.c_str(), vlan.m_vlan_id, port.m_port_id);
 
-    if (tagging_mode == "untagged") // set pvlan id for untagged port only
+    vector<uint32_t> attr_counts;
+    vector<const sai_attribute_t *> attr_lists;
+    for (const auto &attrs : member_attrs)
     {
-        attr.id = SAI_PORT_ATTR_PORT_VLAN_ID;
-        attr.value.u16 = vlan.m_vlan_id;
+        attr_counts.push_back((uint32_t)attrs.size());
+        attr_lists.push_back(attrs.data());
+    }
 
-        status = sai_port_api->set_port_attribute(port.m_port_id, &attr);
-        if (status != SAI_STATUS_SUCCESS)
+    vector<sai_object_id_t> vlan_member_ids(pending.size(), SAI_NULL_OBJECT_ID);
+    vector<sai_status_t> statuses(pending.size(), SAI_STATUS_SUCCESS);
+    sai_status_t status = SAI_STATUS_NOT_IMPLEMENTED;
+
+    if (sai_vlan_api->create_vlan_members)
+    {
+        status = sai_vlan_api->create_vlan_members(gSwitchId, (uint32_t)pending.size(),
+                attr_counts.data(), attr_lists.data(), SAI_BULK_OP_TYPE_INGORE_ERROR,
+                vlan_member_ids.data(), statuses.data());
+    }
+
+    if (status == SAI_STATUS_NOT_IMPLEMENTED)
+    {
+        for (size_t i = 0; i < pending.size(); i++)
         {
-            SWSS_LOG_ERROR("Failed to set port VLAN ID vid:%hu pid:%lx",
-                    vlan.m_vlan_id, port.m_port_id);
-            return false;
+            statuses[i] = sai_vlan_api->create_vlan_member(&vlan_member_ids[i], gSwitchId,
+                    attr_counts[i], attr_lists[i]);
         }
-
-        SWSS_LOG_NOTICE("Set untagged port %s VLAN ID to %hu", port.m_alias.c_str(), vlan.m_vlan_id);
     }
 
-    port.m_vlan_id = vlan.m_vlan_id;
-    port.m_port_vlan_id = vlan.m_vlan_id;
-    port.m_vlan_member_id = vlan_member_id;
-    m_portList[port.m_alias] = port;
-    vlan.m_members.insert(port.m_alias);
-    m_portList[vlan.m_alias] = vlan;
+    for (size_t i = 0; i < pending.size(); i++)
+    {
+        Port &vlan = *pending[i]->vlan;
+        Port &port = *pending[i]->port;
+
+        if (statuses[i] != SAI_STATUS_SUCCESS)
+        {
+            SWSS_LOG_ERROR("Failed to add member %s to VLAN %s vid:%hu pid:%lx rv:%d",
+                    port.m_alias.c_str(), vlan.m_alias.c_str(), vlan.m_vlan_id, port.m_port_id, statuses[i]);
+            continue;
+        }
+
+        if (pending[i]->tagging_mode == SAI_VLAN_TAGGING_MODE_UNTAGGED) // set pvlan id for untagged port only
+        {
+            sai_attribute_t attr;
+            attr.id = SAI_PORT_ATTR_PORT_VLAN_ID;
+            attr.value.u16 = vlan.m_vlan_id;
 
-    VlanMemberUpdate update = { vlan, port, true };
-    notify(SUBJECT_TYPE_VLAN_MEMBER_CHANGE, static_cast<void *>(&update));
+            status = sai_port_api->set_port_attribute(port.m_port_id, &attr);
+            if (status != SAI_STATUS_SUCCESS)
+            {
+                SWSS_LOG_ERROR("Failed to set port VLAN ID vid:%hu pid:%lx rv:%d",
+                        vlan.m_vlan_id, port.m_port_id, status);
 
-    return true;
+                /* Roll back the member, the request is retried as a whole */
+                status = sai_vlan_api->remove_vlan_member(vlan_member_ids[i]);
+                if (status != SAI_STATUS_SUCCESS)
+                {
+                    SWSS_LOG_ERROR("Failed to remove member %s from VLAN %s vmid:%lx rv:%d",
+                            port.m_alias.c_str(), vlan.m_alias.c_str(), vlan_member_ids[i], status);
+                }
+                continue;
+            }
+
+            port.m_port_vlan_id = vlan.m_vlan_id;
+            SWSS_LOG_NOTICE("Set untagged port %s VLAN ID to %hu", port.m_alias.c_str(), vlan.m_vlan_id);
+        }
+
+        SWSS_LOG_NOTICE("Add member %s to VLAN %s vid:%hu pid%lx",
+                port.m_alias.c_str(), vlan.m_alias.c_str(), vlan.m_vlan_id, port.m_port_id);
+
+        port.m_vlan_id = vlan.m_vlan_id;
+        port.m_vlan_member_id = vlan_member_ids[i];
+        vlan.m_members.insert(port.m_alias);
+
+        pending[i]->done = true;
+
+        VlanMemberUpdate update = { vlan, port, true };
+        notify(SUBJECT_TYPE_VLAN_MEMBER_CHANGE, static_cast<void *>(&update));
+    }
 }
 
-bool PortsOrch::removeVlanMember(Port vlan, Port port)
+/*
+ * Remove all VLAN members with a single bulk call, falling back to one SAI
+ * call per member, and reset the port VLAN ID of the removed members.
+ */
+void PortsOrch::removeVlanMembers(vector<VlanMemberRequest> &requests)
 {
     SWSS_LOG_ENTER();
 
-    sai_status_t status = sai_vlan_api->remove_vlan_member(port.m_vlan_member_id);
+    if (requests.empty())
+    {
+        return;
+    }
 
-    if (status != SAI_STATUS_SUCCESS)
+    vector<sai_object_id_t> vlan_member_ids;
+    for (const auto &request : requests)
     {
-        SWSS_LOG_ERROR("Failed to remove member %s from VLAN %s vid:%hx vmid:%lx",
-                port.m_alias.c_str(), vlan.m_alias.c_str(), vlan.m_vlan_id, port.m_vlan_member_id);
-        return false;
+        vlan_member_ids.push_back(request.port->m_vlan_member_id);
     }
 
-    SWSS_LOG_NOTICE("Remove member %s from VLAN %s lid:%hx vmid:%lx",
-            port.m_alias.c_str(), vlan.m_alias.c_str(), vlan.m_vlan_id, port.m_vlan_member_id);
+    vector<sai_status_t> statuses(requests.size(), SAI_STATUS_SUCCESS);
+    sai_status_t status = SAI_STATUS_NOT_IMPLEMENTED;
 
-    sai_attribute_t attr;
-    attr.id = SAI_PORT_ATTR_PORT_VLAN_ID;
-    attr.value.u16 = DEFAULT_PORT_VLAN_ID;
+    if (sai_vlan_api->remove_vlan_members)
+    {
+        status = sai_vlan_api->remove_vlan_members((uint32_t)vlan_member_ids.size(),
+                vlan_member_ids.data(), SAI_BULK_OP_TYPE_INGORE_ERROR, statuses.data());
+    }
 
-    status = sai_port_api->set_port_attribute(port.m_port_id, &attr);
-    if (status != SAI_STATUS_SUCCESS)
+    if (status == SAI_STATUS_NOT_IMPLEMENTED)
     {
-        SWSS_LOG_ERROR("Failed to reset port VLAN ID to DEFAULT_PORT_VLAN_ID pid:%lx",
-                port.m_port_id);
-        return false;
+        for (size_t i = 0; i < vlan_member_ids.size(); i++)
+        {
+            statuses[i] = sai_vlan_api->remove_vlan_member(vlan_member_ids[i]);
+        }
     }
 
-    port.m_vlan_id = 0;
-    port.m_port_vlan_id = DEFAULT_PORT_VLAN_ID;
-    port.m_vlan_member_id = 0;
-    m_portList[port.m_alias] = port;
-    vlan.m_members.erase(port.m_alias);
-    m_portList[vlan.m_alias] = vlan;
+    for (size_t i = 0; i < requests.size(); i++)
+    {
+        Port &vlan = *requests[i].vlan;
+        Port &port = *requests[i].port;
 
-    VlanMemberUpdate update = { vlan, port, false };
-    notify(SUBJECT_TYPE_VLAN_MEMBER_CHANGE, static_cast<void *>(&update));
+        if (statuses[i] != SAI_STATUS_SUCCESS)
+        {
+            SWSS_LOG_ERROR("Failed to remove member %s from VLAN %s vid:%hx vmid:%lx rv:%d",
+                    port.m_alias.c_str(), vlan.m_alias.c_str(), vlan.m_vlan_id, port.m_vlan_member_id, statuses[i]);
+            continue;
+        }
 
-    return true;
+        SWSS_LOG_NOTICE("Remove member %s from VLAN %s lid:%hx vmid:%lx",
+                port.m_alias.c_str(), vlan.m_alias.c_str(), vlan.m_vlan_id, port.m_vlan_member_id);
+
+        port.m_vlan_id = 0;
+        port.m_vlan_member_id = 0;
+        vlan.m_members.erase(port.m_alias);
+
+        if (port.m_port_vlan_id != DEFAULT_PORT_VLAN_ID)
+        {
+            sai_attribute_t attr;
+            attr.id = SAI_PORT_ATTR_PORT_VLAN_ID;
+            attr.value.u16 = DEFAULT_PORT_VLAN_ID;
+
+            status = sai_port_api->set_port_attribute(port.m_port_id, &attr);
+            if (status != SAI_STATUS_SUCCESS)
+            {
+                SWSS_LOG_ERROR("Failed to reset port VLAN ID to DEFAULT_PORT_VLAN_ID pid:%lx",
+                        port.m_port_id);
+            }
+            else
+            {
+                port.m_port_vlan_id = DEFAULT_PORT_VLAN_ID;
+            }
+        }
+
+        requests[i].done = true;
+
+        VlanMemberUpdate update = { vlan, port, false };
+        notify(SUBJECT_TYPE_VLAN_MEMBER_CHANGE, static_cast<void *>(&update));
+    }
 }
 
 bool PortsOrch::addLag(string lag_alias)
@@ -1427,7 +1675,7 @@ bool PortsOrch::removeLag(Port lag)
     return true;
 }
 
-bool PortsOrch::addLagMember(Port lag, Port port)
+bool PortsOrch::addLagMember(Port &lag, Port &port)
 {
     SWSS_LOG_ENTER();
 
@@ -1457,18 +1705,15 @@ bool PortsOrch::addLagMember(Port lag, Port port)
 
     port.m_lag_id = lag.m_lag_id;
     port.m_lag_member_id = lag_member_id;
-    m_portList[port.m_alias] = port;
     lag.m_members.insert(port.m_alias);
 
-    m_portList[lag.m_alias] = lag;
-
     LagMemberUpdate update = { lag, port, true };
     notify(SUBJECT_TYPE_LAG_MEMBER_CHANGE, static_cast<void *>(&update));
 
     return true;
 }
 
-bool PortsOrch::removeLagMember(Port lag, Port port)
+bool PortsOrch::removeLagMember(Port &lag, Port &port)
 {
     sai_status_t status = sai_lag_api->remove_lag_member(port.m_lag_member_id);
 
@@ -1484,12 +1729,35 @@ bool PortsOrch::removeLagMember(Port lag, Port port)
 
     port.m_lag_id = 0;
     port.m_lag_member_id = 0;
-    m_portList[port.m_alias] = port;
+    port.m_lag_member_egress_disabled = false;
     lag.m_members.erase(port.m_alias);
-    m_portList[lag.m_alias] = lag;
 
     LagMemberUpdate update = { lag, port, false };
     notify(SUBJECT_TYPE_LAG_MEMBER_CHANGE, static_cast<void *>(&update));
 
     return true;
 }
+
+bool PortsOrch::setLagMemberEgress(Port &port, bool enable)
+{
+    SWSS_LOG_ENTER();
+
+    sai_attribute_t attr;
+    attr.id = SAI_LAG_MEMBER_ATTR_EGRESS_DISABLE;
+    attr.value.booldata = !enable;
+
+    sai_status_t status = sai_lag_api->set_lag_member_attribute(port.m_lag_member_id, &attr);
+    if (status != SAI_STATUS_SUCCESS)
+    {
+        SWSS_LOG_ERROR("Failed to %s egress of LAG member %s lmid:%lx, rv:%d",
+                enable ? "enable" : "disable", port.m_alias.c_str(), port.m_lag_member_id, status);
+        return false;
+    }
+
+    SWSS_LOG_NOTICE("%s egress of LAG member %s lmid:%lx",
+            enable ? "Enable" : "Disable", port.m_alias.c_str(), port.m_lag_member_id);
+
+    port.m_lag_member_egress_disabled = !enable;
+
+    return true;
+}
@@ -2,6 +2,7 @@
 #define SWSS_PORTSORCH_H
 
 #include <map>
+#include <chrono>
 
 #include "orch.h"
 #include "port.h"
@@ -24,6 +25,13 @@ static const map<sai_port_oper_status_t, string> oper_status_strings =
     { SAI_PORT_OPER_STATUS_NOT_PRESENT, "not present" }
 };
 
+/* Queues and priority groups of a physical port */
+struct PortQosObjects
+{
+    vector<sai_object_id_t> queue_ids;
+    vector<sai_object_id_t> priority_group_ids;
+};
+
 struct LagMemberUpdate
 {
     Port lag;
@@ -38,6 +46,16 @@ struct VlanMemberUpdate
     bool add;
 };
 
+/* A VLAN member operation queued by doVlanMemberTask */
+struct VlanMemberRequest
+{
+    SyncMap::iterator task;
+    Port *vlan;
+    Port *port;
+    sai_vlan_tagging_mode_t tagging_mode;
+    bool done;
+};
+
 class PortsOrch : public Orch, public Subject
 {
 public:
@@ -46,18 +64,30 @@ public:
     bool isInitDone();
 
     map<string, Port>& getAllPorts();
+
+    /*
+     * Non-owning lookups returning NULL when the port is not found. The Port
+     * is owned by PortsOrch and may be modified in place; the pointer stays
+     * valid until the port, VLAN or LAG is removed.
+     */
+    Port *findPort(const string &alias);
+    Port *findPort(sai_object_id_t id);
+    Port *findPortByBridgePortId(sai_object_id_t bridge_port_id);
+
+    /* Copying lookups, for callers keeping a snapshot of the port */
     bool getBridgePort(sai_object_id_t id, Port &port);
     bool getPort(string alias, Port &port);
     bool getPort(sai_object_id_t id, Port &port);
     bool getPortByBridgePortId(sai_object_id_t bridge_port_id, Port &port);
-    void setPort(string alias, Port port);
     void getCpuPort(Port &port);
 
     bool setHostIntfsOperStatus(sai_object_id_t id, bool up);
     void updateDbPortOperStatus(sai_object_id_t id, sai_port_oper_status_t status);
+    void updateLagMemberEgress(sai_object_id_t id, bool up);
 private:
     unique_ptr<Table> m_counterTable;
     unique_ptr<Table> m_portTable;
+    unique_ptr<Table> m_lagMemberTable;
 
     std::map<sai_object_id_t, PortSupportedSpeeds> m_portSupportedSpeeds;
 
@@ -70,6 +100,13 @@ private:
     sai_uint32_t m_portCount;
     map<set<int>, sai_object_id_t> m_portListLaneMap;
     map<string, Port> m_portList;
+    map<sai_object_id_t, PortQosObjects> m_portQosObjects;
+
+    /* Port initialization timing, reported on ConfigDone */
+    size_t m_portInitCount = 0;
+    chrono::duration<double, milli> m_portInitTime = chrono::duration<double, milli>::zero();
+    string m_portInitSlowest;
+    chrono::duration<double, milli> m_portInitSlowestTime = chrono::duration<double, milli>::zero();
 
     void doTask(Consumer &consumer);
     void doPortTask(Consumer &consumer);
@@ -81,9 +118,8 @@ private:
     void removeDefaultVlanMembers();
     void removeDefaultBridgePorts();
 
+    void discoverPort(sai_object_id_t id, set<int> &lane_set);
     bool initializePort(Port &port);
-    void initializePriorityGroups(Port &port);
-    void initializeQueues(Port &port);
 
     bool addHostIntfs(sai_object_id_t router_intfs_id, string alias, sai_object_id_t &host_intfs_id);
 
@@ -92,13 +128,14 @@ private:
 
     bool addVlan(string vlan);
     bool removeVlan(Port vlan);
-    bool addVlanMember(Port vlan, Port port, string& tagging_mode);
-    bool removeVlanMember(Port vlan, Port port);
+    void addVlanMembers(vector<VlanMemberRequest> &requests);
+    void removeVlanMembers(vector<VlanMemberRequest> &requests);
 
     bool addLag(string lag);
     bool removeLag(Port lag);
-    bool addLagMember(Port lag, Port port);
-    bool removeLagMember(Port lag, Port port);
+    bool addLagMember(Port &lag, Port &port);
+    bool removeLagMember(Port &lag, Port &port);
+    bool setLagMemberEgress(Port &port, bool enable);
 
     bool setPortAdminStatus(sai_object_id_t id, bool up);
     bool setPortMtu(sai_object_id_t id, sai_uint32_t mtu);
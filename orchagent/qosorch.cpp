@@ -52,13 +52,11 @@ type_map QosOrch::m_qos_maps = {
     {APP_PFC_PRIORITY_TO_QUEUE_MAP_NAME, new object_map()}
 };
 
-task_process_status QosMapHandler::processWorkItem(Consumer& consumer)
+task_process_status QosMapHandler::processWorkItem(Consumer &consumer, KeyOpFieldsValuesTuple &tuple)
 {
     SWSS_LOG_ENTER();
 
     sai_object_id_t sai_object = SAI_NULL_OBJECT_ID;
-    auto it = consumer.m_toSync.begin();
-    KeyOpFieldsValuesTuple tuple = it->second;
     string qos_object_name = kfvKey(tuple);
     string qos_map_type_name = consumer.m_consumer->getTableName();
     string op = kfvOp(tuple);
@@ -82,7 +80,8 @@ task_process_status QosMapHandler::processWorkItem(Consumer& consumer)
                 freeAttribResources(attributes);
                 return task_process_status::task_failed;
             }
-            SWSS_LOG_NOTICE("Set [%s:%s]", qos_map_type_name.c_str(), qos_object_name.c_str());
+            SWSS_LOG_NOTICE("Set [%s:%s], referrers:%zd", qos_map_type_name.c_str(), qos_object_name.c_str(),
+                            Orch::getObjectReferrers(Orch::getObjectKey(qos_map_type_name, qos_object_name)).size());
         }
         else
         {
@@ -105,6 +104,11 @@ task_process_status QosMapHandler::processWorkItem(Consumer& consumer)
             SWSS_LOG_ERROR("Object with name:%s not found.", qos_object_name.c_str());
             return task_process_status::task_invalid_entry;
         }
+        if (Orch::isObjectReferenced(Orch::getObjectKey(qos_map_type_name, qos_object_name)))
+        {
+            SWSS_LOG_INFO("[%s:%s] is still referenced, deferring removal", qos_map_type_name.c_str(), qos_object_name.c_str());
+            return task_process_status::task_need_retry;
+        }
         if (!removeQosItem(sai_object))
         {
             SWSS_LOG_ERROR("Failed to remove dscp_to_tc map. db name:%s sai object:%lx", qos_object_name.c_str(), sai_object);
@@ -200,11 +204,11 @@ sai_object_id_t DscpToTcMapHandler::addQosItem(const vector<sai_attribute_t> &at
     return sai_object;
 }
 
-task_process_status QosOrch::handleDscpToTcTable(Consumer& consumer)
+task_process_status QosOrch::handleDscpToTcTable(Consumer &consumer, KeyOpFieldsValuesTuple &tuple)
 {
     SWSS_LOG_ENTER();
     DscpToTcMapHandler dscp_tc_handler;
-    return dscp_tc_handler.processWorkItem(consumer);
+    return dscp_tc_handler.processWorkItem(consumer, tuple);
 }
 
 bool TcToQueueMapHandler::convertFieldValuesToAttributes(KeyOpFieldsValuesTuple &tuple, vector<sai_attribute_t> &attributes)
@@ -253,11 +257,11 @@ sai_object_id_t TcToQueueMapHandler::addQosItem(const vector<sai_attribute_t> &a
     return sai_object;
 }
 
-task_process_status QosOrch::handleTcToQueueTable(Consumer& consumer)
+task_process_status QosOrch::handleTcToQueueTable(Consumer &consumer, KeyOpFieldsValuesTuple &tuple)
 {
     SWSS_LOG_ENTER();
     TcToQueueMapHandler tc_queue_handler;
-    return tc_queue_handler.processWorkItem(consumer);
+    return tc_queue_handler.processWorkItem(consumer, tuple);
 }
 
 void WredMapHandler::freeAttribResources(vector<sai_attribute_t> &attributes)
@@ -431,11 +435,11 @@ bool WredMapHandler::removeQosItem(sai_object_id_t sai_object)
     return true;
 }
 
-task_process_status QosOrch::handleWredProfileTable(Consumer& consumer)
+task_process_status QosOrch::handleWredProfileTable(Consumer &consumer, KeyOpFieldsValuesTuple &tuple)
 {
     SWSS_LOG_ENTER();
     WredMapHandler wred_handler;
-    return wred_handler.processWorkItem(consumer);
+    return wred_handler.processWorkItem(consumer, tuple);
 }
 
 bool TcToPgHandler::convertFieldValuesToAttributes(KeyOpFieldsValuesTuple &tuple, vector<sai_attribute_t> &attributes)
@@ -484,11 +488,11 @@ sai_object_id_t TcToPgHandler::addQosItem(const vector<sai_attribute_t> &attribu
 
 }
 
-task_process_status QosOrch::handleTcToPgTable(Consumer& consumer)
+task_process_status QosOrch::handleTcToPgTable(Consumer &consumer, KeyOpFieldsValuesTuple &tuple)
 {
     SWSS_LOG_ENTER();
     TcToPgHandler tc_to_pg_handler;
-    return tc_to_pg_handler.processWorkItem(consumer);
+    return tc_to_pg_handler.processWorkItem(consumer, tuple);
 }
 
 bool PfcPrioToPgHandler::convertFieldValuesToAttributes(KeyOpFieldsValuesTuple &tuple, vector<sai_attribute_t> &attributes)
@@ -538,11 +542,11 @@ sai_object_id_t PfcPrioToPgHandler::addQosItem(const vector<sai_attribute_t> &at
 
 }
 
-task_process_status QosOrch::handlePfcPrioToPgTable(Consumer& consumer)
+task_process_status QosOrch::handlePfcPrioToPgTable(Consumer &consumer, KeyOpFieldsValuesTuple &tuple)
 {
     SWSS_LOG_ENTER();
     PfcPrioToPgHandler pfc_prio_to_pg_handler;
-    return pfc_prio_to_pg_handler.processWorkItem(consumer);
+    return pfc_prio_to_pg_handler.processWorkItem(consumer, tuple);
 }
 
 bool PfcToQueueHandler::convertFieldValuesToAttributes(KeyOpFieldsValuesTuple &tuple, vector<sai_attribute_t> &attributes)
@@ -593,11 +597,11 @@ sai_object_id_t PfcToQueueHandler::addQosItem(const vector<sai_attribute_t> &att
 
 }
 
-task_process_status QosOrch::handlePfcToQueueTable(Consumer& consumer)
+task_process_status QosOrch::handlePfcToQueueTable(Consumer &consumer, KeyOpFieldsValuesTuple &tuple)
 {
     SWSS_LOG_ENTER();
     PfcToQueueHandler pfc_to_queue_handler;
-    return pfc_to_queue_handler.processWorkItem(consumer);
+    return pfc_to_queue_handler.processWorkItem(consumer, tuple);
 }
 
 QosOrch::QosOrch(DBConnector *db, vector<string> &tableNames) : Orch(db, tableNames)
@@ -756,14 +760,13 @@ void QosOrch::initTableHandlers()
     m_qos_handler_map.insert(qos_handler_pair(APP_PFC_PRIORITY_TO_QUEUE_MAP_NAME, &QosOrch::handlePfcToQueueTable));
 }
 
-task_process_status QosOrch::handleSchedulerTable(Consumer& consumer)
+task_process_status QosOrch::handleSchedulerTable(Consumer &consumer, KeyOpFieldsValuesTuple &tuple)
 {
     SWSS_LOG_ENTER();
 
     sai_status_t sai_status;
     sai_object_id_t sai_object = SAI_NULL_OBJECT_ID;
 
-    KeyOpFieldsValuesTuple tuple = consumer.m_toSync.begin()->second;
     string qos_map_type_name = APP_SCHEDULER_TABLE_NAME;
     string qos_object_name = kfvKey(tuple);
     string op = kfvOp(tuple);
@@ -823,6 +826,8 @@ task_process_status QosOrch::handleSchedulerTable(Consumer& consumer)
 
         if (SAI_NULL_OBJECT_ID != sai_object)
         {
+            SWSS_LOG_INFO("Modifying [%s:%s], referrers:%zd", qos_map_type_name.c_str(), qos_object_name.c_str(),
+                          getObjectReferrers(getObjectKey(qos_map_type_name, qos_object_name)).size());
             for (auto attr : sai_attr_list)
             {
                 sai_status = sai_scheduler_api->set_scheduler_attribute(sai_object, &attr);
@@ -853,6 +858,11 @@ task_process_status QosOrch::handleSchedulerTable(Consumer& consumer)
             SWSS_LOG_ERROR("Object with name:%s not found.", qos_object_name.c_str());
             return task_process_status::task_invalid_entry;
         }
+        if (isObjectReferenced(getObjectKey(qos_map_type_name, qos_object_name)))
+        {
+            SWSS_LOG_INFO("[%s:%s] is still referenced, deferring removal", qos_map_type_name.c_str(), qos_object_name.c_str());
+            return task_process_status::task_need_retry;
+        }
         sai_status = sai_scheduler_api->remove_scheduler(sai_object);
         if (SAI_STATUS_SUCCESS != sai_status)
         {
@@ -997,12 +1007,9 @@ bool QosOrch::applyWredProfileToQueue(Port &port, size_t queue_ind, sai_object_i
     return true;
 }
 
-task_process_status QosOrch::handleQueueTable(Consumer& consumer)
+task_process_status QosOrch::handleQueueTable(Consumer &consumer, KeyOpFieldsValuesTuple &tuple)
 {
     SWSS_LOG_ENTER();
-    auto it = consumer.m_toSync.begin();
-    KeyOpFieldsValuesTuple tuple = it->second;
-    Port port;
     bool result;
     string key = kfvKey(tuple);
     string op = kfvOp(tuple);
@@ -1013,6 +1020,30 @@ task_process_status QosOrch::handleQueueTable(Consumer& consumer)
     vector<string> port_names;
 
     ref_resolve_status  resolve_result;
+    string referrer = getObjectKey(consumer.m_consumer->getTableName(), key);
+    set<string> references;
+
+    vector<FieldValueTuple> fields = kfvFieldsValues(tuple);
+    if (op == DEL_COMMAND && fields.empty())
+    {
+        /* DEL carries no fields, unbind whatever the queue was bound to */
+        for (auto &object : getObjectReferences(referrer))
+        {
+            string table_name = object.substr(0, object.find(delimiter));
+            string ref = ref_start + object + ref_end;
+            if (table_name == APP_SCHEDULER_TABLE_NAME)
+            {
+                fields.push_back(FieldValueTuple(scheduler_field_name, ref));
+            }
+            else if (table_name == APP_WRED_PROFILE_TABLE_NAME)
+            {
+                fields.push_back(FieldValueTuple(wred_profile_field_name, ref));
+            }
+        }
+    }
+    /* Resolve from a copy, the tuple stays queued as is if the task is retried */
+    KeyOpFieldsValuesTuple queue_tuple(key, op, fields);
+
     // sample "QUEUE_TABLE:ETHERNET4:1"
     tokens = tokenize(key, delimiter);
     if (tokens.size() != 2)
@@ -1028,9 +1059,9 @@ task_process_status QosOrch::handleQueueTable(Consumer& consumer)
     }
     for (string port_name : port_names)
     {
-        Port port;
         SWSS_LOG_DEBUG("processing port:%s", port_name.c_str());
-        if (!gPortsOrch->getPort(port_name, port))
+        Port *port = gPortsOrch->findPort(port_name);
+        if (!port)
         {
             SWSS_LOG_ERROR("Port with alias:%s not found", port_name.c_str());
             return task_process_status::task_invalid_entry;
@@ -1041,17 +1072,17 @@ task_process_status QosOrch::handleQueueTable(Consumer& consumer)
             queue_ind = ind;
             SWSS_LOG_DEBUG("processing queue:%zd", queue_ind);
             sai_object_id_t sai_scheduler_profile;
-            resolve_result = resolveFieldRefValue(m_qos_maps, scheduler_field_name, tuple, sai_scheduler_profile);
+            resolve_result = resolveFieldRefValue(m_qos_maps, scheduler_field_name, queue_tuple, sai_scheduler_profile, &references);
             if (ref_resolve_status::success == resolve_result)
             {
                 if (op == SET_COMMAND)
                 {
-                    result = applySchedulerToQueueSchedulerGroup(port, queue_ind, sai_scheduler_profile);
+                    result = applySchedulerToQueueSchedulerGroup(*port, queue_ind, sai_scheduler_profile);
                 }
                 else if (op == DEL_COMMAND)
                 {
                     // NOTE: The map is un-bound from the port. But the map itself still exists.
-                    result = applySchedulerToQueueSchedulerGroup(port, queue_ind, SAI_NULL_OBJECT_ID);
+                    result = applySchedulerToQueueSchedulerGroup(*port, queue_ind, SAI_NULL_OBJECT_ID);
                 }
                 else
                 {
@@ -1060,7 +1091,7 @@ task_process_status QosOrch::handleQueueTable(Consumer& consumer)
                 }
                 if (!result)
                 {
-                    SWSS_LOG_ERROR("Failed setting field:%s to port:%s, queue:%zd, line:%d", scheduler_field_name.c_str(), port.m_alias.c_str(), queue_ind, __LINE__);
+                    SWSS_LOG_ERROR("Failed setting field:%s to port:%s, queue:%zd, line:%d", scheduler_field_name.c_str(), port->m_alias.c_str(), queue_ind, __LINE__);
                     return task_process_status::task_failed;
                 }
                 SWSS_LOG_DEBUG("Applied scheduler to port:%s", port_name.c_str());
@@ -1077,17 +1108,17 @@ task_process_status QosOrch::handleQueueTable(Consumer& consumer)
             }
 
             sai_object_id_t sai_wred_profile;
-            resolve_result = resolveFieldRefValue(m_qos_maps, wred_profile_field_name, tuple, sai_wred_profile);
+            resolve_result = resolveFieldRefValue(m_qos_maps, wred_profile_field_name, queue_tuple, sai_wred_profile, &references);
             if (ref_resolve_status::success == resolve_result)
             {
                 if (op == SET_COMMAND)
                 {
-                    result = applyWredProfileToQueue(port, queue_ind, sai_wred_profile);
+                    result = applyWredProfileToQueue(*port, queue_ind, sai_wred_profile);
                 }
                 else if (op == DEL_COMMAND)
                 {
                     // NOTE: The map is un-bound from the port. But the map itself still exists.
-                    result = applyWredProfileToQueue(port, queue_ind, SAI_NULL_OBJECT_ID);
+                    result = applyWredProfileToQueue(*port, queue_ind, SAI_NULL_OBJECT_ID);
                 }
                 else
                 {
@@ -1096,7 +1127,7 @@ task_process_status QosOrch::handleQueueTable(Consumer& consumer)
                 }
                 if (!result)
                 {
-                    SWSS_LOG_ERROR("Failed setting field:%s to port:%s, queue:%zd, line:%d", wred_profile_field_name.c_str(), port.m_alias.c_str(), queue_ind, __LINE__);
+                    SWSS_LOG_ERROR("Failed setting field:%s to port:%s, queue:%zd, line:%d", wred_profile_field_name.c_str(), port->m_alias.c_str(), queue_ind, __LINE__);
                     return task_process_status::task_failed;
                 }
                 SWSS_LOG_DEBUG("Applied wred profile to port:%s", port_name.c_str());
@@ -1113,6 +1144,14 @@ task_process_status QosOrch::handleQueueTable(Consumer& consumer)
             }
         }
     }
+    if (op == DEL_COMMAND)
+    {
+        removeObjectReferences(referrer);
+    }
+    else
+    {
+        setObjectReferences(referrer, references);
+    }
     SWSS_LOG_DEBUG("finished");
     return task_process_status::task_success;
 }
@@ -1183,15 +1222,44 @@ task_process_status QosOrch::ResolveMapAndApplyToPort(
     return task_process_status::task_success;
 }
 
-task_process_status QosOrch::handlePortQosMapTable(Consumer& consumer)
+task_process_status QosOrch::handlePortQosMapTable(Consumer &consumer, KeyOpFieldsValuesTuple &tuple)
 {
     SWSS_LOG_ENTER();
 
-    KeyOpFieldsValuesTuple tuple = consumer.m_toSync.begin()->second;
     string key = kfvKey(tuple);
     string op = kfvOp(tuple);
 
+    string referrer = getObjectKey(consumer.m_consumer->getTableName(), key);
+    vector<string> port_names = tokenize(key, list_item_delimiter);
+
+    if (op == DEL_COMMAND)
+    {
+        /* Unbind the maps from the ports so that they can be removed */
+        for (string port_name : port_names)
+        {
+            Port *port = gPortsOrch->findPort(port_name);
+            if (!port)
+            {
+                continue;
+            }
+
+            auto &applied_maps = m_portQosMaps[port->m_port_id];
+            for (auto it = applied_maps.begin(); it != applied_maps.end(); )
+            {
+                if (!applyMapToPort(*port, it->first, SAI_NULL_OBJECT_ID))
+                {
+                    return task_process_status::task_failed;
+                }
+                it = applied_maps.erase(it);
+            }
+        }
+        removeObjectReferences(referrer);
+        SWSS_LOG_NOTICE("Removed QoS maps from ports %s", key.c_str());
+        return task_process_status::task_success;
+    }
+
     sai_uint8_t pfc_enable = 0;
+    set<string> references;
     map<sai_port_attr_t, pair<string, sai_object_id_t>> update_list;
     for (auto it = kfvFieldsValues(tuple).begin(); it != kfvFieldsValues(tuple).end(); it++)
     {
@@ -1200,7 +1268,7 @@ task_process_status QosOrch::handlePortQosMapTable(Consumer& consumer)
         {
             sai_object_id_t id;
             string map_type_name = fvField(*it), map_name = fvValue(*it);
-            ref_resolve_status status = resolveFieldRefValue(m_qos_maps, map_type_name, tuple, id);
+            ref_resolve_status status = resolveFieldRefValue(m_qos_maps, map_type_name, tuple, id, &references);
 
             if (status != ref_resolve_status::success)
             {
@@ -1223,92 +1291,158 @@ task_process_status QosOrch::handlePortQosMapTable(Consumer& consumer)
         }
     }
 
-    vector<string> port_names = tokenize(key, list_item_delimiter);
-    for (string port_name : port_names)
+    /* Collect the attributes of all ports first, skipping the ones already applied */
+    struct port_qos_update
     {
-        Port port;
+        string port_name;
+        sai_object_id_t port_id;
+        sai_attribute_t attr;
+        string name;
+    };
+    vector<port_qos_update> updates;
 
+    for (string port_name : port_names)
+    {
         /* Skip port which is not found */
-        if (!gPortsOrch->getPort(port_name, port))
+        Port *port = gPortsOrch->findPort(port_name);
+        if (!port)
         {
             SWSS_LOG_ERROR("Failed to apply QoS maps to port %s. Port is not found.", port_name.c_str());
             continue;
         }
 
-        /* Apply a list of attributes to be applied */
+        auto &applied_maps = m_portQosMaps[port->m_port_id];
         for (auto it = update_list.begin(); it != update_list.end(); it++)
         {
-            sai_attribute_t attr;
-            attr.id = it->first;
-            attr.value.oid = it->second.second;
-
-            sai_status_t status = sai_port_api->set_port_attribute(port.m_port_id, &attr);
-            if (status != SAI_STATUS_SUCCESS)
+            auto applied = applied_maps.find(it->first);
+            if (applied != applied_maps.end() && applied->second == it->second.second)
             {
-                SWSS_LOG_ERROR("Failed to apply %s to port %s, rv:%d",
-                               it->second.first.c_str(), port_name.c_str(), status);
-                return task_process_status::task_invalid_entry;
+                continue;
             }
-            SWSS_LOG_INFO("Applied %s to port %s", it->second.first.c_str(), port_name.c_str());
+
+            port_qos_update update = { port_name, port->m_port_id, { }, it->second.first };
+            update.attr.id = it->first;
+            update.attr.value.oid = it->second.second;
+            updates.push_back(update);
         }
 
         if (pfc_enable)
         {
-            sai_attribute_t attr;
-            attr.id = SAI_PORT_ATTR_PRIORITY_FLOW_CONTROL;
-            attr.value.u8 = pfc_enable;
+            auto applied = m_portPfcBits.find(port->m_port_id);
+            if (applied == m_portPfcBits.end() || applied->second != pfc_enable)
+            {
+                port_qos_update update = { port_name, port->m_port_id, { }, "PFC bits" };
+                update.attr.id = SAI_PORT_ATTR_PRIORITY_FLOW_CONTROL;
+                update.attr.value.u8 = pfc_enable;
+                updates.push_back(update);
+            }
+        }
+    }
+
+    /* Apply the attributes which changed */
+    for (const auto &update : updates)
+    {
+        sai_status_t status = sai_port_api->set_port_attribute(update.port_id, &update.attr);
 
-            sai_status_t status = sai_port_api->set_port_attribute(port.m_port_id, &attr);
+        if (update.attr.id == SAI_PORT_ATTR_PRIORITY_FLOW_CONTROL)
+        {
             if (status != SAI_STATUS_SUCCESS)
             {
                 SWSS_LOG_ERROR("Failed to apply PFC bits 0x%x to port %s, rv:%d",
-                               pfc_enable, port_name.c_str(), status);
+                               pfc_enable, update.port_name.c_str(), status);
+                continue;
             }
-            SWSS_LOG_INFO("Applied PFC bits 0x%x to port %s", pfc_enable, port_name.c_str());
+            m_portPfcBits[update.port_id] = pfc_enable;
+            SWSS_LOG_INFO("Applied PFC bits 0x%x to port %s", pfc_enable, update.port_name.c_str());
+            continue;
         }
+
+        if (status != SAI_STATUS_SUCCESS)
+        {
+            SWSS_LOG_ERROR("Failed to apply %s to port %s, rv:%d",
+                           update.name.c_str(), update.port_name.c_str(), status);
+            return task_process_status::task_invalid_entry;
+        }
+        m_portQosMaps[update.port_id][static_cast<sai_port_attr_t>(update.attr.id)] = update.attr.value.oid;
+        SWSS_LOG_INFO("Applied %s to port %s", update.name.c_str(), update.port_name.c_str());
     }
 
+    setObjectReferences(referrer, references);
     SWSS_LOG_NOTICE("Applied QoS maps to ports");
     return task_process_status::task_success;
 }
 
+void QosOrch::doTask()
+{
+    /* Process the tables in dependency order: QoS maps, schedulers and WRED profiles before the queues and ports using them */
+    static const vector<string> tableOrder = {
+        APP_DSCP_TO_TC_MAP_TABLE_NAME,
+        APP_TC_TO_QUEUE_MAP_TABLE_NAME,
+        APP_TC_TO_PRIORITY_GROUP_MAP_NAME,
+        APP_PFC_PRIORITY_TO_PRIORITY_GROUP_MAP_NAME,
+        APP_PFC_PRIORITY_TO_QUEUE_MAP_NAME,
+        APP_SCHEDULER_TABLE_NAME,
+        APP_WRED_PROFILE_TABLE_NAME,
+        APP_QUEUE_TABLE_NAME,
+        APP_PORT_QOS_MAP_TABLE_NAME
+    };
+
+    Orch::doTask(tableOrder);
+}
+
 void QosOrch::doTask(Consumer &consumer)
 {
     SWSS_LOG_ENTER();
+
+    /* Make sure the handler is initialized for the task */
+    auto qos_map_type_name = consumer.m_consumer->getTableName();
+    auto handler_it = m_qos_handler_map.find(qos_map_type_name);
+    if (handler_it == m_qos_handler_map.end())
+    {
+        SWSS_LOG_ERROR("Task %s handler is not initialized", qos_map_type_name.c_str());
+        consumer.m_toSync.clear();
+        return;
+    }
+    auto handler = handler_it->second;
+
+    /* Process the whole batch with the same handler, the status is kept per item */
+    size_t retried = 0;
+    size_t failed = 0;
     auto it = consumer.m_toSync.begin();
     while (it != consumer.m_toSync.end())
     {
-        /* Make sure the handler is initialized for the task */
-        auto qos_map_type_name = consumer.m_consumer->getTableName();
-        if (m_qos_handler_map.find(qos_map_type_name) == m_qos_handler_map.end())
-        {
-            SWSS_LOG_ERROR("Task %s handler is not initialized", qos_map_type_name.c_str());
-            it = consumer.m_toSync.erase(it);
-            continue;
-        }
-
-        auto task_status = (this->*(m_qos_handler_map[qos_map_type_name]))(consumer);
+        auto task_status = (this->*handler)(consumer, it->second);
         switch(task_status)
         {
             case task_process_status::task_success :
                 it = consumer.m_toSync.erase(it);
                 break;
             case task_process_status::task_invalid_entry :
-                SWSS_LOG_ERROR("Failed to process invalid QOS task");
+                SWSS_LOG_ERROR("Failed to process invalid QOS task %s", it->first.c_str());
                 it = consumer.m_toSync.erase(it);
+                failed++;
                 break;
             case task_process_status::task_failed :
-                SWSS_LOG_ERROR("Failed to process QOS task, drop it");
+                SWSS_LOG_ERROR("Failed to process QOS task %s, drop it", it->first.c_str());
                 it = consumer.m_toSync.erase(it);
-                return;
+                failed++;
+                break;
             case task_process_status::task_need_retry :
-                SWSS_LOG_INFO("Failed to process QOS task, retry it");
+                SWSS_LOG_INFO("Failed to process QOS task %s, retry it", it->first.c_str());
                 it++;
+                retried++;
                 break;
             default:
                 SWSS_LOG_ERROR("Invalid task status %d", task_status);
                 it = consumer.m_toSync.erase(it);
+                failed++;
                 break;
         }
     }
+
+    if (retried || failed)
+    {
+        SWSS_LOG_INFO("Processed QOS table %s: %zd failed, %zd pending retry",
+                      qos_map_type_name.c_str(), failed, retried);
+    }
 }
@@ -128,6 +128,14 @@ void RouteOrch::attach(Observer *observer, const IpAddress& dstAddr)
                 observerEntry->second.routeTable.emplace(route.first, route.second);
             }
         }
+
+        for (const auto &route : m_syncdIntfRoutes)
+        {
+            if (route.first.isAddressInSubnet(dstAddr))
+            {
+                observerEntry->second.routeTable.emplace(route.first, IpAddresses());
+            }
+        }
     }
 
     observerEntry->second.observers.push_back(observer);
@@ -135,7 +143,7 @@ void RouteOrch::attach(Observer *observer, const IpAddress& dstAddr)
     auto route = observerEntry->second.routeTable.rbegin();
     if (route != observerEntry->second.routeTable.rend())
     {
-        NextHopUpdate update = { route->first, route->second };
+        NextHopUpdate update = getNextHopUpdate(dstAddr, route->first, route->second);
         observer->update(SUBJECT_TYPE_NEXTHOP_CHANGE, static_cast<void *>(&update));
     }
 }
@@ -179,7 +187,8 @@ void RouteOrch::doTask(Consumer& consumer)
          * routes as dirty and waits for 'resync complete' message. For all
          * newly received routes, if they match current dirty routes, it unmarks
          * them dirty. After receiving 'resync complete' message, it creates all
-         * newly added routes and removes all dirty routes.
+         * newly added routes and removes all dirty routes. Interface routes
+         * are owned by IntfsOrch and are kept intact during resync.
          */
         if (key == "resync")
         {
@@ -298,7 +307,7 @@ void RouteOrch::notifyNextHopChangeObservers(IpPrefix prefix, IpAddresses nextho
         if (add)
         {
             bool update_required = false;
-            NextHopUpdate update = { prefix, nexthops };
+            NextHopUpdate update = getNextHopUpdate(entry.first, prefix, nexthops);
 
             /* Table should not be empty. Default route should always exists. */
             assert(!entry.second.routeTable.empty());
@@ -349,7 +358,7 @@ void RouteOrch::notifyNextHopChangeObservers(IpPrefix prefix, IpAddresses nextho
                     assert(!entry.second.routeTable.empty());
 
                     auto route = entry.second.routeTable.rbegin();
-                    NextHopUpdate update = { route->first, route->second };
+                    NextHopUpdate update = getNextHopUpdate(entry.first, route->first, route->second);
 
                     for (auto observer : entry.second.observers)
                     {
@@ -365,6 +374,17 @@ void RouteOrch::notifyNextHopChangeObservers(IpPrefix prefix, IpAddresses nextho
     }
 }
 
+NextHopUpdate RouteOrch::getNextHopUpdate(const IpAddress& dstAddr, const IpPrefix& prefix, const IpAddresses& nexthops)
+{
+    /* A destination inside a directly connected subnet is its own next hop */
+    if (nexthops.getSize() == 0 && m_syncdIntfRoutes.find(prefix) != m_syncdIntfRoutes.end())
+    {
+        return { dstAddr, prefix, IpAddresses(dstAddr.to_string()) };
+    }
+
+    return { dstAddr, prefix, nexthops };
+}
+
 void RouteOrch::increaseNextHopRefCount(IpAddresses ipAddresses)
 {
     /* Return when there is no next hop (dropped) */
@@ -587,6 +607,15 @@ bool RouteOrch::addRoute(IpPrefix ipPrefix, IpAddresses nextHops)
 {
     SWSS_LOG_ENTER();
 
+    /* The prefix is an interface subnet or ip2me route owned by IntfsOrch.
+     * Queued interface routes wait for this route instead. */
+    if (isIntfRoute(ipPrefix))
+    {
+        SWSS_LOG_INFO("Route %s is in use by an interface route",
+                ipPrefix.to_string().c_str());
+        return false;
+    }
+
     /* next_hop_id indicates the next hop id or next hop group id of this route */
     sai_object_id_t next_hop_id;
     auto it_route = m_syncdRoutes.find(ipPrefix);
@@ -810,6 +839,219 @@ bool RouteOrch::removeRoute(IpPrefix ipPrefix)
 
         /* Notify about the route next hop removal */
         notifyNextHopChangeObservers(ipPrefix, IpAddresses(), false);
+
+        /* Program the interface route that was waiting for the prefix */
+        if (m_toAddIntfRoutes.find(ipPrefix) != m_toAddIntfRoutes.end())
+        {
+            flushIntfRoutes();
+        }
+    }
+    return true;
+}
+
+bool RouteOrch::isIntfRoute(const IpPrefix& ipPrefix) const
+{
+    return m_syncdIntfRoutes.find(ipPrefix) != m_syncdIntfRoutes.end();
+}
+
+/* Subnet and ip2me routes of one prefix would be the same route entry */
+bool RouteOrch::hasIntfRouteConflict(const IpPrefix& ipPrefix, bool subnet) const
+{
+    auto it = m_syncdIntfRoutes.find(ipPrefix);
+    if (it != m_syncdIntfRoutes.end() && it->second.subnet != subnet)
+    {
+        return true;
+    }
+
+    it = m_toAddIntfRoutes.find(ipPrefix);
+    return it != m_toAddIntfRoutes.end() && it->second.subnet != subnet;
+}
+
+bool RouteOrch::addIntfRoute(const IpPrefix& ipPrefix, sai_object_id_t nextHopId, bool subnet)
+{
+    SWSS_LOG_ENTER();
+
+    if (hasIntfRouteConflict(ipPrefix, subnet))
+    {
+        SWSS_LOG_ERROR("Interface route %s already exists as %s route",
+                ipPrefix.to_string().c_str(), subnet ? "ip2me" : "subnet");
+        return false;
     }
+
+    m_toAddIntfRoutes[ipPrefix] = { nextHopId, subnet };
     return true;
 }
+
+void RouteOrch::removeIntfRoute(const IpPrefix& ipPrefix)
+{
+    SWSS_LOG_ENTER();
+
+    /* The route has not been flushed to the ASIC yet */
+    if (m_toAddIntfRoutes.erase(ipPrefix))
+    {
+        return;
+    }
+
+    m_toRemoveIntfRoutes.insert(ipPrefix);
+}
+
+sai_route_entry_t RouteOrch::getIntfRouteEntry(const IpPrefix& ipPrefix)
+{
+    sai_route_entry_t route_entry;
+    route_entry.switch_id = gSwitchId;
+    route_entry.vr_id = gVirtualRouterId;
+    copy(route_entry.destination, ipPrefix);
+
+    return route_entry;
+}
+
+/*
+ * Remove all queued interface routes first, then create the queued ones, each
+ * with a single bulk call. Falls back to one SAI call per route when the bulk
+ * API is not implemented by the SAI library.
+ */
+void RouteOrch::flushIntfRoutes()
+{
+    SWSS_LOG_ENTER();
+
+    bool failed = false;
+
+    if (!m_toRemoveIntfRoutes.empty())
+    {
+        vector<IpPrefix> prefixes;
+        vector<sai_route_entry_t> route_entries;
+
+        for (const auto &prefix : m_toRemoveIntfRoutes)
+        {
+            auto it = m_syncdIntfRoutes.find(prefix);
+            if (it == m_syncdIntfRoutes.end())
+            {
+                SWSS_LOG_ERROR("Failed to locate interface route %s", prefix.to_string().c_str());
+                continue;
+            }
+
+            prefixes.push_back(prefix);
+            route_entries.push_back(getIntfRouteEntry(prefix));
+        }
+        m_toRemoveIntfRoutes.clear();
+
+        vector<sai_status_t> statuses(route_entries.size(), SAI_STATUS_SUCCESS);
+        sai_status_t status = SAI_STATUS_NOT_IMPLEMENTED;
+
+        if (!route_entries.empty() && sai_route_api->remove_route_entries)
+        {
+            status = sai_route_api->remove_route_entries((uint32_t)route_entries.size(),
+                    route_entries.data(), SAI_BULK_OP_TYPE_INGORE_ERROR, statuses.data());
+        }
+
+        if (status == SAI_STATUS_NOT_IMPLEMENTED)
+        {
+            for (size_t i = 0; i < route_entries.size(); i++)
+            {
+                statuses[i] = sai_route_api->remove_route_entry(&route_entries[i]);
+            }
+        }
+
+        for (size_t i = 0; i < prefixes.size(); i++)
+        {
+            if (statuses[i] != SAI_STATUS_SUCCESS)
+            {
+                SWSS_LOG_ERROR("Failed to remove interface route %s, rv:%d",
+                        prefixes[i].to_string().c_str(), statuses[i]);
+                failed = true;
+                continue;
+            }
+
+            m_syncdIntfRoutes.erase(prefixes[i]);
+            notifyNextHopChangeObservers(prefixes[i], IpAddresses(), false);
+
+            SWSS_LOG_NOTICE("Remove interface route %s", prefixes[i].to_string().c_str());
+        }
+    }
+
+    if (!m_toAddIntfRoutes.empty())
+    {
+        vector<IpPrefix> prefixes;
+        vector<sai_route_entry_t> route_entries;
+        vector<vector<sai_attribute_t>> route_attrs;
+
+        for (const auto &it : m_toAddIntfRoutes)
+        {
+            /* Wait for the route from APP_DB to be removed first */
+            if (m_syncdRoutes.find(it.first) != m_syncdRoutes.end())
+            {
+                SWSS_LOG_NOTICE("Defer interface route %s, the prefix is in use by a route",
+                        it.first.to_string().c_str());
+                continue;
+            }
+
+            sai_attribute_t attr;
+            vector<sai_attribute_t> attrs;
+
+            attr.id = SAI_ROUTE_ENTRY_ATTR_PACKET_ACTION;
+            attr.value.s32 = SAI_PACKET_ACTION_FORWARD;
+            attrs.push_back(attr);
+
+            attr.id = SAI_ROUTE_ENTRY_ATTR_NEXT_HOP_ID;
+            attr.value.oid = it.second.next_hop_id;
+            attrs.push_back(attr);
+
+            prefixes.push_back(it.first);
+            route_entries.push_back(getIntfRouteEntry(it.first));
+            route_attrs.push_back(attrs);
+        }
+
+        vector<uint32_t> attr_counts;
+        vector<const sai_attribute_t *> attr_lists;
+        for (const auto &attrs : route_attrs)
+        {
+            attr_counts.push_back((uint32_t)attrs.size());
+            attr_lists.push_back(attrs.data());
+        }
+
+        vector<sai_status_t> statuses(route_entries.size(), SAI_STATUS_SUCCESS);
+        sai_status_t status = SAI_STATUS_NOT_IMPLEMENTED;
+
+        if (!route_entries.empty() && sai_route_api->create_route_entries)
+        {
+            status = sai_route_api->create_route_entries((uint32_t)route_entries.size(),
+                    route_entries.data(), attr_counts.data(), attr_lists.data(),
+                    SAI_BULK_OP_TYPE_INGORE_ERROR, statuses.data());
+        }
+
+        if (status == SAI_STATUS_NOT_IMPLEMENTED)
+        {
+            for (size_t i = 0; i < route_entries.size(); i++)
+            {
+                statuses[i] = sai_route_api->create_route_entry(&route_entries[i],
+                        attr_counts[i], attr_lists[i]);
+            }
+        }
+
+        for (size_t i = 0; i < prefixes.size(); i++)
+        {
+            if (statuses[i] != SAI_STATUS_SUCCESS)
+            {
+                SWSS_LOG_ERROR("Failed to create interface route %s, rv:%d",
+                        prefixes[i].to_string().c_str(), statuses[i]);
+                failed = true;
+                continue;
+            }
+
+            m_syncdIntfRoutes[prefixes[i]] = m_toAddIntfRoutes[prefixes[i]];
+            notifyNextHopChangeObservers(prefixes[i], IpAddresses(), true);
+
+            SWSS_LOG_NOTICE("Create interface route %s", prefixes[i].to_string().c_str());
+        }
+
+        for (const auto &prefix : prefixes)
+        {
+            m_toAddIntfRoutes.erase(prefix);
+        }
+    }
+
+    if (failed)
+    {
+        throw runtime_error("Failed to flush interface routes.");
+    }
+}
@@ -24,18 +24,27 @@ struct NextHopGroupEntry
 
 struct NextHopUpdate
 {
+    IpAddress destination;      // observed destination IP address
     IpPrefix prefix;
     IpAddresses nexthopGroup;
 };
 
 struct NextHopObserverEntry;
 
+struct IntfRouteEntry
+{
+    sai_object_id_t next_hop_id;    // router interface id or CPU port id
+    bool            subnet;         // subnet route to a router interface, else ip2me route
+};
+
 /* NextHopGroupTable: next hop group IP addersses, NextHopGroupEntry */
 typedef std::map<IpAddresses, NextHopGroupEntry> NextHopGroupTable;
 /* RouteTable: destination network, next hop IP address(es) */
 typedef std::map<IpPrefix, IpAddresses> RouteTable;
 /* NextHopObserverTable: Destination IP address, next hop observer entry */
 typedef std::map<IpAddress, NextHopObserverEntry> NextHopObserverTable;
+/* IntfRouteTable: masked interface subnet or ip2me host prefix, interface route entry */
+typedef std::map<IpPrefix, IntfRouteEntry> IntfRouteTable;
 
 struct NextHopObserverEntry
 {
@@ -61,6 +70,16 @@ public:
     bool addNextHopGroup(IpAddresses);
     bool removeNextHopGroup(IpAddresses);
 
+    /* Interface subnet and ip2me routes are queued by IntfsOrch and
+     * programmed in bulk on flushIntfRoutes(). They share the route entry
+     * space with m_syncdRoutes: a prefix is owned by either an interface
+     * route or a route from APP_DB, and the other one waits until it is
+     * released. */
+    bool hasIntfRouteConflict(const IpPrefix&, bool) const;
+    bool addIntfRoute(const IpPrefix&, sai_object_id_t, bool);
+    void removeIntfRoute(const IpPrefix&);
+    void flushIntfRoutes();
+
 private:
     NeighOrch *m_neighOrch;
 
@@ -73,6 +92,10 @@ private:
 
     NextHopObserverTable m_nextHopObservers;
 
+    IntfRouteTable m_syncdIntfRoutes;
+    IntfRouteTable m_toAddIntfRoutes;
+    std::set<IpPrefix> m_toRemoveIntfRoutes;
+
     void addTempRoute(IpPrefix, IpAddresses);
     bool addRoute(IpPrefix, IpAddresses);
     bool removeRoute(IpPrefix);
@@ -80,6 +103,9 @@ private:
     void doTask(Consumer& consumer);
 
     void notifyNextHopChangeObservers(IpPrefix, IpAddresses, bool);
+    NextHopUpdate getNextHopUpdate(const IpAddress&, const IpPrefix&, const IpAddresses&);
+    bool isIntfRoute(const IpPrefix&) const;
+    sai_route_entry_t getIntfRouteEntry(const IpPrefix&);
 };
 
 #endif /* SWSS_ROUTEORCH_H */
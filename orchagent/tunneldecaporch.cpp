@@ -1,4 +1,6 @@
 #include <string.h>
+#include <algorithm>
+#include <iterator>
 #include "tunneldecaporch.h"
 #include "logger.h"
 #include "swssnet.h"
@@ -280,7 +282,7 @@ bool TunnelDecapOrch::addDecapTunnel(string key, string type, IpAddresses dst_ip
     // there should also be "business logic" for netbouncer in the "tunnel application" code, which is a different source file and daemon process
 
     // create a decap tunnel entry for every ip
-    if (!addDecapTunnelTermEntries(key, dst_ip, tunnel_id))
+    if (!addDecapTunnelTermEntries(key, dst_ip.getIpAddresses(), tunnel_id))
     {
         return false;
     }
@@ -290,17 +292,17 @@ bool TunnelDecapOrch::addDecapTunnel(string key, string type, IpAddresses dst_ip
 
 /**
  * Function Description:
- *    @brief adds a decap tunnel termination entry to ASIC_DB
+ *    @brief adds decap tunnel termination entries to ASIC_DB
  *
  * Arguments:
  *    @param[in] tunnelKey - key of the tunnel from APP_DB
- *    @param[in] dst_ip - destination ip addresses to decap
+ *    @param[in] dst_ips - destination ip addresses to decap
  *    @param[in] tunnel_id - the id of the tunnel
  *
  * Return Values:
  *    @return true on success and false if there's an error
  */
-bool TunnelDecapOrch::addDecapTunnelTermEntries(string tunnelKey, IpAddresses dst_ip, sai_object_id_t tunnel_id)
+bool TunnelDecapOrch::addDecapTunnelTermEntries(string tunnelKey, const set<IpAddress> &dst_ips, sai_object_id_t tunnel_id)
 {
     SWSS_LOG_ENTER();
 
@@ -324,48 +326,46 @@ bool TunnelDecapOrch::addDecapTunnelTermEntries(string tunnelKey, IpAddresses ds
     attr.value.oid = tunnel_id;
     tunnel_table_entry_attrs.push_back(attr);
 
+    // the destination ip is the last attribute and is rewritten for every entry
+    attr.id = SAI_TUNNEL_TERM_TABLE_ENTRY_ATTR_DST_IP;
+    tunnel_table_entry_attrs.push_back(attr);
+    sai_attribute_t &dst_ip_attr = tunnel_table_entry_attrs.back();
+
     TunnelEntry *tunnel_info = &tunnelTable.find(tunnelKey)->second;
 
-    // loop through the IP list and create a new tunnel table entry for every IP (in network byte order)
-    set<IpAddress> tunnel_ips = dst_ip.getIpAddresses();
-    for (auto it = tunnel_ips.begin(); it != tunnel_ips.end(); ++it)
+    // create a new tunnel table entry for every IP (in network byte order) that has none yet
+    for (const auto &ia : dst_ips)
     {
-        const IpAddress& ia = *it;
-        string ip = ia.to_string();
-
         // check if the there's an entry already for the ip
-        if (existingIps.find(ip) != existingIps.end())
-        {
-            SWSS_LOG_ERROR("%s already exists. Did not create entry.", ip.c_str());
-        }
-        else
+        if (existingIps.find(ia) != existingIps.end())
         {
-            attr.id = SAI_TUNNEL_TERM_TABLE_ENTRY_ATTR_DST_IP;
-            copy(attr.value.ipaddr, ia);
-            tunnel_table_entry_attrs.push_back(attr);
-
-            // create the tunnel table entry
-            sai_object_id_t tunnel_term_table_entry_id;
-            sai_status_t status = sai_tunnel_api->create_tunnel_term_table_entry(&tunnel_term_table_entry_id, gSwitchId, (uint32_t)tunnel_table_entry_attrs.size(), tunnel_table_entry_attrs.data());
-            if (status != SAI_STATUS_SUCCESS)
+            if (tunnel_info->tunnel_term_info.find(ia) == tunnel_info->tunnel_term_info.end())
             {
-                SWSS_LOG_ERROR("Failed to create tunnel entry table for ip: %s", ip.c_str());
-                return false;
+                SWSS_LOG_ERROR("%s already exists. Did not create entry.", ia.to_string().c_str());
             }
+            continue;
+        }
 
-            // insert into ip to entry mapping
-            existingIps.insert(ip);
+        copy(dst_ip_attr.value.ipaddr, ia);
 
-            // insert entry id and ip into tunnel mapping
-            tunnel_info->tunnel_term_info.push_back({ tunnel_term_table_entry_id, ip });
+        // create the tunnel table entry
+        sai_object_id_t tunnel_term_table_entry_id;
+        sai_status_t status = sai_tunnel_api->create_tunnel_term_table_entry(&tunnel_term_table_entry_id, gSwitchId, (uint32_t)tunnel_table_entry_attrs.size(), tunnel_table_entry_attrs.data());
+        if (status != SAI_STATUS_SUCCESS)
+        {
+            SWSS_LOG_ERROR("Failed to create tunnel entry table for ip: %s", ia.to_string().c_str());
+            return false;
+        }
 
-            // pop the last element for the next loop
-            tunnel_table_entry_attrs.pop_back();
+        // insert into ip to entry mapping
+        existingIps.insert(ia);
 
-            SWSS_LOG_NOTICE("Created tunnel entry for ip: %s", ip.c_str());
-        }
+        // insert entry id and ip into tunnel mapping
+        tunnel_info->tunnel_term_info[ia] = tunnel_term_table_entry_id;
 
+        SWSS_LOG_NOTICE("Created tunnel entry for ip: %s", ia.to_string().c_str());
     }
+
     return true;
 }
 
@@ -454,32 +454,29 @@ bool TunnelDecapOrch::setIpAttribute(string key, IpAddresses new_ip_addresses, s
 {
     TunnelEntry *tunnel_info = &tunnelTable.find(key)->second;
 
-    // make a copy of tunnel_term_info to loop through
-    vector<TunnelTermEntry> tunnel_term_info_copy(tunnel_info->tunnel_term_info);
+    const set<IpAddress> &new_ips = new_ip_addresses.getIpAddresses();
+    set<IpAddress> current_ips;
+    for (const auto &it : tunnel_info->tunnel_term_info)
+    {
+        current_ips.insert(current_ips.end(), it.first);
+    }
 
-    tunnel_info->tunnel_term_info.clear();
+    // both sets are ordered, so the differences are computed in one linear pass each
+    set<IpAddress> removed_ips;
+    set_difference(current_ips.begin(), current_ips.end(), new_ips.begin(), new_ips.end(),
+            inserter(removed_ips, removed_ips.end()));
 
-    // loop through original ips and remove ips not in the new ip_addresses
-    for (auto it = tunnel_term_info_copy.begin(); it != tunnel_term_info_copy.end(); ++it)
+    set<IpAddress> added_ips;
+    set_difference(new_ips.begin(), new_ips.end(), current_ips.begin(), current_ips.end(),
+            inserter(added_ips, added_ips.end()));
+
+    // remove the ips that are gone before adding the new ones
+    if (!removeDecapTunnelTermEntries(key, removed_ips))
     {
-        TunnelTermEntry tunnel_entry_info = *it;
-        string ip = tunnel_entry_info.ip_address;
-        if (!new_ip_addresses.contains(ip))
-        {
-            if (!removeDecapTunnelTermEntry(tunnel_entry_info.tunnel_term_id, ip))
-            {
-                return false;
-            }
-        }
-        else
-        {
-            // add the data into the tunnel_term_info
-            tunnel_info->tunnel_term_info.push_back({ tunnel_entry_info.tunnel_term_id, ip });
-        }
+        return false;
     }
 
-    // add all the new ip addresses
-    if(!addDecapTunnelTermEntries(key, new_ip_addresses, tunnel_id))
+    if (!addDecapTunnelTermEntries(key, added_ips, tunnel_id))
     {
         return false;
     }
@@ -502,17 +499,17 @@ bool TunnelDecapOrch::removeDecapTunnel(string key)
     sai_status_t status;
     TunnelEntry *tunnel_info = &tunnelTable.find(key)->second;
 
-    // loop through the tunnel entry ids related to the tunnel and remove them before removing the tunnel
-    for (auto it = tunnel_info->tunnel_term_info.begin(); it != tunnel_info->tunnel_term_info.end(); ++it)
+    // remove the tunnel entries related to the tunnel before removing the tunnel
+    set<IpAddress> tunnel_ips;
+    for (const auto &it : tunnel_info->tunnel_term_info)
     {
-        TunnelTermEntry tunnel_entry_info = *it;
-        if (!removeDecapTunnelTermEntry(tunnel_entry_info.tunnel_term_id, tunnel_entry_info.ip_address))
-        {
-            return false;
-        }
+        tunnel_ips.insert(tunnel_ips.end(), it.first);
     }
 
-    tunnel_info->tunnel_term_info = {};
+    if (!removeDecapTunnelTermEntries(key, tunnel_ips))
+    {
+        return false;
+    }
 
     status = sai_tunnel_api->remove_tunnel(tunnel_info->tunnel_id);
     if (status != SAI_STATUS_SUCCESS)
@@ -526,27 +523,39 @@ bool TunnelDecapOrch::removeDecapTunnel(string key)
 
 /**
  * Function Description:
- *    @brief remove decap tunnel termination entry
+ *    @brief remove decap tunnel termination entries
  *
  * Arguments:
- *    @param[in] key - key of the tunnel from APP_DB
+ *    @param[in] tunnelKey - key of the tunnel from APP_DB
+ *    @param[in] dst_ips - destination ip addresses of the entries to remove
  *
  * Return Values:
  *    @return true on success and false if there's an error
  */
-bool TunnelDecapOrch::removeDecapTunnelTermEntry(sai_object_id_t tunnel_term_id, string ip)
+bool TunnelDecapOrch::removeDecapTunnelTermEntries(string tunnelKey, const set<IpAddress> &dst_ips)
 {
-    sai_status_t status;
+    TunnelEntry *tunnel_info = &tunnelTable.find(tunnelKey)->second;
 
-    status = sai_tunnel_api->remove_tunnel_term_table_entry(tunnel_term_id);
-    if (status != SAI_STATUS_SUCCESS)
+    for (const auto &ia : dst_ips)
     {
-        SWSS_LOG_ERROR("Failed to remove tunnel table entry: %lu", tunnel_term_id);
-        return false;
+        auto it = tunnel_info->tunnel_term_info.find(ia);
+        if (it == tunnel_info->tunnel_term_info.end())
+        {
+            continue;
+        }
+
+        sai_status_t status = sai_tunnel_api->remove_tunnel_term_table_entry(it->second);
+        if (status != SAI_STATUS_SUCCESS)
+        {
+            SWSS_LOG_ERROR("Failed to remove tunnel table entry: %lu", it->second);
+            return false;
+        }
+
+        // making sure to remove all instances of the ip address
+        existingIps.erase(ia);
+        tunnel_info->tunnel_term_info.erase(it);
+        SWSS_LOG_NOTICE("Removed decap tunnel term entry with ip address: %s", ia.to_string().c_str());
     }
 
-    // making sure to remove all instances of the ip address
-    existingIps.erase(ip);
-    SWSS_LOG_NOTICE("Removed decap tunnel term entry with ip address: %s", ip.c_str());
     return true;
 }
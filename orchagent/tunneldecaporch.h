@@ -2,30 +2,27 @@
 #define SWSS_TUNNELDECAPORCH_H
 
 #include <arpa/inet.h>
-#include <unordered_set>
+#include <set>
 
 #include "orch.h"
 #include "sai.h"
 #include "ipaddress.h"
 #include "ipaddresses.h"
 
-struct TunnelTermEntry
-{
-    sai_object_id_t            tunnel_term_id;
-    string                     ip_address;
-};
+/* TunnelTermTable: destination ip, tunnel term table entry id */
+typedef map<IpAddress, sai_object_id_t> TunnelTermTable;
 
 struct TunnelEntry
 {
     sai_object_id_t            tunnel_id;              // tunnel id
-    vector<TunnelTermEntry>    tunnel_term_info;       // tunnel_entry ids related to the tunnel abd ips related to the tunnel (all ips for tunnel entries that refer to this tunnel)
+    TunnelTermTable            tunnel_term_info;       // tunnel term entries of the tunnel keyed by their destination ip
 };
 
 /* TunnelTable: key string, tunnel object id */
 typedef map<string, TunnelEntry> TunnelTable;
 
 /* ExistingIps: ips that currently have term entries */
-typedef unordered_set<string> ExistingIps;
+typedef set<IpAddress> ExistingIps;
 
 class TunnelDecapOrch : public Orch
 {
@@ -39,8 +36,8 @@ private:
     bool addDecapTunnel(string key, string type, IpAddresses dst_ip, IpAddress src_ip, string dscp, string ecn, string ttl);
     bool removeDecapTunnel(string key);
 
-    bool addDecapTunnelTermEntries(string tunnelKey, IpAddresses dst_ip, sai_object_id_t tunnel_id);
-    bool removeDecapTunnelTermEntry(sai_object_id_t tunnel_term_id, string ip);
+    bool addDecapTunnelTermEntries(string tunnelKey, const set<IpAddress> &dst_ips, sai_object_id_t tunnel_id);
+    bool removeDecapTunnelTermEntries(string tunnelKey, const set<IpAddress> &dst_ips);
 
     bool setTunnelAttribute(string field, string value, sai_object_id_t existing_tunnel_id);
     bool setIpAttribute(string key, IpAddresses new_ip_addresses, sai_object_id_t tunnel_id);
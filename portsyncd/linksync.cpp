@@ -27,7 +27,7 @@ const string VLAN_PREFIX = "Vlan";
 const string LAG_PREFIX = "PortChannel";
 
 extern set<string> g_portSet;
-extern map<string, set<string>> g_vlanMap;
+extern set<string> g_portTableSet;
 extern bool g_init;
 
 LinkSync::LinkSync(DBConnector *db) :
@@ -63,14 +63,23 @@ LinkSync::LinkSync(DBConnector *db) :
         string vlan = keys[0];
         string member = keys[1];
 
-        if (g_vlanMap.find(vlan) == g_vlanMap.end())
-        {
-            g_vlanMap[vlan] = set<string>();
-        }
-        g_vlanMap[vlan].insert(member);
+        m_memberVlanMap[member].insert(vlan);
     }
 }
 
+/* Write the attributes only if they differ from the ones written last time */
+void LinkSync::setLinkState(ProducerStateTable &table, const string &key, vector<FieldValueTuple> &fvVector)
+{
+    auto it = m_linkStateMap.find(key);
+    if (it != m_linkStateMap.end() && it->second == fvVector)
+    {
+        return;
+    }
+
+    table.set(key, fvVector);
+    m_linkStateMap[key] = fvVector;
+}
+
 void LinkSync::onMsg(int nlmsg_type, struct nl_object *obj)
 {
     if ((nlmsg_type != RTM_NEWLINK) && (nlmsg_type != RTM_DELLINK))
@@ -128,32 +137,37 @@ void LinkSync::onMsg(int nlmsg_type, struct nl_object *obj)
         if (!master_key.compare(0, VLAN_PREFIX.length(), VLAN_PREFIX))
         {
             string member_key = master_key + ":" + key;
+            auto &vlans = m_memberVlanMap[key];
 
             if (nlmsg_type == RTM_DELLINK) /* Will it happen? */
             {
                 m_vlanMemberTableProducer.del(member_key);
+                vlans.erase(master_key);
             }
-            else /* RTM_NEWLINK */
+            /* RTM_NEWLINK: Only a new membership has to be written */
+            else if (vlans.find(master_key) == vlans.end())
             {
                 vector<FieldValueTuple> fvVector;
                 FieldValueTuple t("tagging_mode", "untagged");
                 fvVector.push_back(t);
 
                 m_vlanMemberTableProducer.set(member_key, fvVector);
+                vlans.insert(master_key);
             }
         }
     }
     /* No longer a VLAN member: Check if it was a member before and remove it */
     else
     {
-        for (auto i = g_vlanMap.begin(); i != g_vlanMap.end(); i++)
+        auto it = m_memberVlanMap.find(key);
+        if (it != m_memberVlanMap.end())
         {
-            set<string> member_set = (*i).second;
-            if (member_set.find(key) != member_set.end())
+            for (const auto &vlan : it->second)
             {
-                string member_key = (*i).first + ":" + key;
+                string member_key = vlan + ":" + key;
                 m_vlanMemberTableProducer.del(member_key);
             }
+            m_memberVlanMap.erase(it);
         }
     }
 
@@ -169,12 +183,13 @@ void LinkSync::onMsg(int nlmsg_type, struct nl_object *obj)
         if (nlmsg_type == RTM_DELLINK)
         {
             m_vlanTableProducer.del(key);
+            m_linkStateMap.erase(key);
         }
         else
         {
             FieldValueTuple o("oper_status", oper ? "up" : "down");
             fvVector.push_back(o);
-            m_vlanTableProducer.set(key, fvVector);
+            setLinkState(m_vlanTableProducer, key, fvVector);
         }
         return;
     }
@@ -182,8 +197,7 @@ void LinkSync::onMsg(int nlmsg_type, struct nl_object *obj)
     /* front panel interfaces: Check if the port is in the PORT_TABLE
      * non-front panel interfaces such as eth0, lo which are not in the
      * PORT_TABLE are ignored. */
-    vector<FieldValueTuple> temp;
-    if (m_portTableConsumer.get(key, temp))
+    if (g_portTableSet.find(key) != g_portTableSet.end())
     {
         /* TODO: When port is removed from the kernel */
         if (nlmsg_type == RTM_DELLINK)
@@ -197,6 +211,6 @@ void LinkSync::onMsg(int nlmsg_type, struct nl_object *obj)
             g_portSet.erase(key);
         }
 
-        m_portTableProducer.set(key, fvVector);
+        setLinkState(m_portTableProducer, key, fvVector);
     }
 }
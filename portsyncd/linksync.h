@@ -6,6 +6,9 @@
 #include "netmsg.h"
 
 #include <map>
+#include <set>
+#include <string>
+#include <vector>
 
 namespace swss {
 
@@ -23,6 +26,12 @@ private:
     Table m_portTableConsumer, m_vlanMemberTableConsumer;
 
     std::map<unsigned int, std::string> m_ifindexNameMap;
+    /* Port and VLAN attributes last written to APPL_DB */
+    std::map<std::string, std::vector<FieldValueTuple>> m_linkStateMap;
+    /* VLANs every member interface belongs to */
+    std::map<std::string, std::set<std::string>> m_memberVlanMap;
+
+    void setLinkState(ProducerStateTable &table, const std::string &key, std::vector<FieldValueTuple> &fvVector);
 };
 
 }
@@ -28,7 +28,12 @@ using namespace swss;
  * command to be run only once.
  */
 set<string> g_portSet;
-map<string, set<string>> g_vlanMap;
+/*
+ * g_portTableSet contains all the front panel ports read from the port
+ * configuration file. LinkSync checks it instead of querying PORT_TABLE for
+ * every link message.
+ */
+set<string> g_portTableSet;
 bool g_init = false;
 
 void usage()
@@ -161,6 +166,7 @@ void handlePortConfigFile(ProducerStateTable &p, string file)
         p.set(name, attrs);
 
         g_portSet.insert(name);
+        g_portTableSet.insert(name);
     }
 
     infile.close();
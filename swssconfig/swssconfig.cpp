@@ -1,13 +1,18 @@
 #include <dirent.h>
+#include <getopt.h>
 #include <stdlib.h>
 #include <string.h>
 
+#include <chrono>
 #include <fstream>
 #include <iostream>
+#include <map>
+#include <memory>
 #include <vector>
 
 #include "logger.h"
 #include "dbconnector.h"
+#include "redispipeline.h"
 #include "producerstatetable.h"
 #include "json.hpp"
 
@@ -23,10 +28,21 @@ const int el_count = 2;
 
 const string SWSS_CONFIG_DIR    = "/etc/swss/config.d/";
 
+/* Number of entries sent to redis in one pipelined batch */
+#define DEFAULT_BATCH_SIZE  128
+
+size_t batch_size   = DEFAULT_BATCH_SIZE;
+/* Send every file in one pipeline flush instead of batch_size chunks.
+ * Consumers may still pop the entries before the flush completes. */
+bool single_batch   = false;
+
 void usage()
 {
-    cout << "Usage: swssconfig [FILE...]" << endl;
+    cout << "Usage: swssconfig [-b batch_size] [-s] [FILE...]" << endl;
     cout << "       (default config folder is /etc/swss/config.d/)" << endl;
+    cout << "       -b batch_size: number of entries written to redis in one batch" << endl;
+    cout << "                      default: " << DEFAULT_BATCH_SIZE << endl;
+    cout << "       -s: write every file to redis as a single batch" << endl;
 }
 
 void dump_db_item(KeyOpFieldsValuesTuple &db_item)
@@ -41,9 +57,18 @@ void dump_db_item(KeyOpFieldsValuesTuple &db_item)
     SWSS_LOG_DEBUG("]");
 }
 
+/*
+ * Validate all the items before anything is written, so that a malformed
+ * file is rejected as a whole instead of being applied up to the bad item.
+ * The producers of all tables are created upfront as well, since creating
+ * one loads its script synchronously and would flush the pending batch.
+ * Items are then written in file order through a single pipeline that
+ * sends batch_size entries at a time, or the whole file at once in single
+ * batch mode.
+ */
 bool write_db_data(vector<KeyOpFieldsValuesTuple> &db_items)
 {
-    DBConnector db(APPL_DB, hostname, db_port, 0);
+    vector<pair<string, string>> db_keys;
     for (auto &db_item : db_items)
     {
         dump_db_item(db_item);
@@ -55,20 +80,42 @@ bool write_db_data(vector<KeyOpFieldsValuesTuple> &db_items)
             SWSS_LOG_ERROR("Invalid formatted hash:%s\n", key.c_str());
             return false;
         }
-        string table_name = key.substr(0, pos);
-        string key_name = key.substr(pos + 1);
-        ProducerStateTable producer(&db, table_name);
-
-        if (kfvOp(db_item) == SET_COMMAND)
-            producer.set(key_name, kfvFieldsValues(db_item), SET_COMMAND);
-        else if (kfvOp(db_item) == DEL_COMMAND)
-            producer.del(key_name, DEL_COMMAND);
-        else
+
+        if (kfvOp(db_item) != SET_COMMAND && kfvOp(db_item) != DEL_COMMAND)
         {
             SWSS_LOG_ERROR("Invalid operation: %s\n", kfvOp(db_item).c_str());
             return false;
         }
+
+        db_keys.emplace_back(key.substr(0, pos), key.substr(pos + 1));
     }
+
+    DBConnector db(APPL_DB, hostname, db_port, 0);
+    RedisPipeline pipeline(&db, single_batch ? db_items.size() + 1 : batch_size);
+
+    map<string, unique_ptr<ProducerStateTable>> producers;
+    for (auto &db_key : db_keys)
+    {
+        auto &producer = producers[db_key.first];
+        if (!producer)
+        {
+            producer.reset(new ProducerStateTable(&pipeline, db_key.first, true));
+        }
+    }
+
+    for (size_t i = 0; i < db_items.size(); i++)
+    {
+        auto &producer = producers[db_keys[i].first];
+
+        if (kfvOp(db_items[i]) == SET_COMMAND)
+            producer->set(db_keys[i].second, kfvFieldsValues(db_items[i]), SET_COMMAND);
+        else
+            producer->del(db_keys[i].second, DEL_COMMAND);
+    }
+
+    pipeline.flush();
+
+    SWSS_LOG_NOTICE("Wrote %zu entries of %zu tables", db_items.size(), producers.size());
     return true;
 }
 
@@ -162,24 +209,49 @@ vector<string> read_directory(const string &path)
 
 int main(int argc, char **argv)
 {
-    vector<string> files;
-    if (argc == 1)
+    int opt;
+
+    while ((opt = getopt(argc, argv, "b:sh")) != -1)
     {
-        files = read_directory(SWSS_CONFIG_DIR);
+        switch (opt)
+        {
+        case 'b':
+            batch_size = (size_t)atoi(optarg);
+            if (batch_size == 0)
+            {
+                cerr << "Invalid batch size " << optarg << endl;
+                usage();
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 's':
+            single_batch = true;
+            break;
+        case 'h':
+            usage();
+            exit(EXIT_SUCCESS);
+        default: /* '?' */
+            usage();
+            exit(EXIT_FAILURE);
+        }
     }
-    if (argc == 2 && !strcmp(argv[1], "-h"))
+
+    vector<string> files;
+    if (optind == argc)
     {
-        usage();
-        exit(EXIT_SUCCESS);
+        files = read_directory(SWSS_CONFIG_DIR);
     }
     else
     {
-        for (auto i = 1; i < argc; i++)
+        for (auto i = optind; i < argc; i++)
         {
             files.push_back(string(argv[i]));
         }
     }
 
+    auto start = chrono::steady_clock::now();
+    size_t total_items = 0;
+
     for (auto i : files)
     {
         SWSS_LOG_NOTICE("Loading config from JSON file:%s...", i.c_str());
@@ -201,11 +273,17 @@ int main(int argc, char **argv)
                 return EXIT_FAILURE;
             }
 
+            auto write_start = chrono::steady_clock::now();
             if (!write_db_data(db_items))
             {
                 SWSS_LOG_ERROR("Failed applying data from JSON file %s", i.c_str());
                 return EXIT_FAILURE;
             }
+            chrono::duration<double, milli> write_time = chrono::steady_clock::now() - write_start;
+
+            SWSS_LOG_NOTICE("Applied %zu entries from JSON file %s in %.1f ms",
+                            db_items.size(), i.c_str(), write_time.count());
+            total_items += db_items.size();
         }
         catch(const exception &e)
         {
@@ -215,5 +293,11 @@ int main(int argc, char **argv)
         }
     }
 
+    chrono::duration<double, milli> total_time = chrono::steady_clock::now() - start;
+    SWSS_LOG_NOTICE("Loaded %zu entries from %zu files in %.1f ms",
+                    total_items, files.size(), total_time.count());
+    cout << "Loaded " << total_items << " entries from " << files.size()
+         << " files in " << total_time.count() << " ms" << endl;
+
     return EXIT_SUCCESS;
 }
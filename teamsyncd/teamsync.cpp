@@ -7,6 +7,7 @@
 #include "logger.h"
 #include "netmsg.h"
 #include "dbconnector.h"
+#include "redispipeline.h"
 #include "producerstatetable.h"
 #include "teamsync.h"
 
@@ -16,10 +17,10 @@ using namespace swss;
 /* Taken from drivers/net/team/team.c */
 #define TEAM_DRV_NAME "team"
 
-TeamSync::TeamSync(DBConnector *db, Select *select) :
+TeamSync::TeamSync(RedisPipeline *pipeline, Select *select) :
     m_select(select),
-    m_lagTable(db, APP_LAG_TABLE_NAME),
-    m_lagMemberTable(db, APP_LAG_MEMBER_TABLE_NAME)
+    m_lagTable(pipeline, APP_LAG_TABLE_NAME, true),
+    m_lagMemberTable(pipeline, APP_LAG_MEMBER_TABLE_NAME, true)
 {
 }
 
@@ -140,10 +141,15 @@ TeamSync::TeamPortSync::~TeamPortSync()
     }
 }
 
+/*
+ * Members are updated in place: a member is written only when it is new or
+ * its status changes, and a member not seen in this pass has left the LAG.
+ */
 int TeamSync::TeamPortSync::onChange()
 {
     struct team_port *port;
-    map<string, bool> tmp_lag_members;
+
+    m_generation++;
 
     /* Check each port  */
     team_for_each_port(port, m_team)
@@ -160,33 +166,37 @@ int TeamSync::TeamPortSync::onChange()
             continue;
 
         team_get_port_enabled(m_team, ifindex, &enabled);
-        tmp_lag_members[string(ifname)] = enabled;
-    }
 
-    /* Compare old and new LAG members and set/del accordingly */
-    for (auto it : tmp_lag_members)
-    {
-        if (m_lagMembers.find(it.first) == m_lagMembers.end() || it.second != m_lagMembers[it.first])
+        auto member = m_lagMembers.find(ifname);
+        if (member == m_lagMembers.end())
         {
-            string key = m_lagName + ":" + it.first;
-            vector<FieldValueTuple> v;
-            FieldValueTuple l("status", it.second ? "enabled" : "disabled");
-            v.push_back(l);
-            m_lagMemberTable->set(key, v);
+            /* Start from the opposite status so that a new member is written */
+            member = m_lagMembers.emplace(ifname, LagMemberState{ !enabled, 0 }).first;
         }
+
+        member->second.generation = m_generation;
+        if (member->second.enabled == enabled)
+            continue;
+
+        member->second.enabled = enabled;
+
+        vector<FieldValueTuple> v;
+        FieldValueTuple l("status", enabled ? "enabled" : "disabled");
+        v.push_back(l);
+        m_lagMemberTable->set(m_lagName + ":" + member->first, v);
     }
 
-    for (auto it : m_lagMembers)
+    for (auto it = m_lagMembers.begin(); it != m_lagMembers.end(); )
     {
-        if (tmp_lag_members.find(it.first) == tmp_lag_members.end())
+        if (it->second.generation != m_generation)
         {
-            string key = m_lagName + ":" + it.first;
-            m_lagMemberTable->del(key);
+            m_lagMemberTable->del(m_lagName + ":" + it->first);
+            it = m_lagMembers.erase(it);
         }
+        else
+            it++;
     }
 
-    /* Replace the old LAG members with the new ones */
-    m_lagMembers = tmp_lag_members;
     return 0;
 }
 
@@ -5,6 +5,7 @@
 #include <string>
 #include <memory>
 #include "dbconnector.h"
+#include "redispipeline.h"
 #include "producerstatetable.h"
 #include "selectable.h"
 #include "select.h"
@@ -16,7 +17,11 @@ namespace swss {
 class TeamSync : public NetMsg
 {
 public:
-    TeamSync(DBConnector *db, Select *select);
+    /*
+     * LAG and LAG member updates are buffered on the pipeline, which is
+     * flushed once per select wakeup by the caller
+     */
+    TeamSync(RedisPipeline *pipeline, Select *select);
 
     /*
      * Listens to RTM_NEWLINK and RTM_DELLINK to undestand if there is a new
@@ -43,11 +48,18 @@ public:
                                 team_change_type_mask_t type_mask);
         static const struct team_change_handler gPortChangeHandler;
     private:
+        struct LagMemberState
+        {
+            bool enabled;           /* status (enabled|disabled) */
+            unsigned int generation; /* last onChange() the member was seen in */
+        };
+
         ProducerStateTable *m_lagMemberTable;
         struct team_handle *m_team;
         std::string m_lagName;
         int m_ifindex;
-        std::map<std::string, bool> m_lagMembers; /* map[ifname] = status (enabled|disabled) */
+        unsigned int m_generation = 0;
+        std::map<std::string, LagMemberState> m_lagMembers; /* map[ifname] = state */
     };
 
 protected:
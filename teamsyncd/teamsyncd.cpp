@@ -13,8 +13,9 @@ int main(int argc, char **argv)
 {
     swss::Logger::linkToDbNative("teamsyncd");
     DBConnector db(APPL_DB, DBConnector::DEFAULT_UNIXSOCKET, 0);
+    RedisPipeline pipeline(&db);
     Select s;
-    TeamSync sync(&db, &s);
+    TeamSync sync(&pipeline, &s);
 
     NetDispatcher::getInstance().registerMessageHandler(RTM_NEWLINK, &sync);
     NetDispatcher::getInstance().registerMessageHandler(RTM_DELLINK, &sync);
@@ -35,6 +36,15 @@ int main(int argc, char **argv)
                 Selectable *temps;
                 int tempfd;
                 s.select(&temps, &tempfd);
+
+                /* select() handles one selectable per call, drain the ones
+                 * already ready so that their changes share the flush */
+                while (s.select(&temps, &tempfd, 0) == Select::OBJECT)
+                {
+                }
+
+                /* Write all LAG and member changes of this wakeup at once */
+                pipeline.flush();
             }
         }
         catch (const std::exception& e)
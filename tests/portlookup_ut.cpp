@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <map>
+#include <string>
+#include <iostream>
+#include "port.h"
+
+using namespace std;
+using namespace swss;
+
+/*
+ * PortsOrch cannot be linked into this binary, so the two lookup flavours
+ * are reproduced on the same container: getPort() copies the Port out of
+ * m_portList, findPort() returns a pointer into it.
+ */
+static bool getPort(map<string, Port> &portList, const string &alias, Port &p)
+{
+    auto it = portList.find(alias);
+    if (it == portList.end())
+    {
+        return false;
+    }
+
+    p = it->second;
+    return true;
+}
+
+static Port *findPort(map<string, Port> &portList, const string &alias)
+{
+    auto it = portList.find(alias);
+    if (it == portList.end())
+    {
+        return NULL;
+    }
+
+    return &it->second;
+}
+
+static map<string, Port> makePortList(size_t portCount, size_t queueCount)
+{
+    map<string, Port> portList;
+
+    Port lag("PortChannel0001", Port::LAG);
+    Port vlan("Vlan1000", Port::VLAN);
+
+    for (size_t i = 0; i < portCount; i++)
+    {
+        Port port("Ethernet" + to_string(i * 4), Port::PHY);
+        port.m_port_id = 0x1000000000000 + i;
+        port.m_queue_ids.assign(queueCount, 0x15000000000000 + i);
+        port.m_priority_group_ids.assign(queueCount, 0x1a000000000000 + i);
+
+        lag.m_members.insert(port.m_alias);
+        vlan.m_members.insert(port.m_alias);
+        portList[port.m_alias] = port;
+    }
+
+    portList[lag.m_alias] = lag;
+    portList[vlan.m_alias] = vlan;
+
+    return portList;
+}
+
+TEST(portlookup, find_matches_get)
+{
+    auto portList = makePortList(4, 8);
+
+    Port port;
+    ASSERT_TRUE(getPort(portList, "Ethernet4", port));
+
+    Port *found = findPort(portList, "Ethernet4");
+    ASSERT_NE(found, nullptr);
+    EXPECT_EQ(found->m_port_id, port.m_port_id);
+    EXPECT_EQ(found->m_queue_ids, port.m_queue_ids);
+
+    /* Updates through the pointer land in the list */
+    found->m_rif_id = 0x6000000000001;
+    EXPECT_EQ(portList["Ethernet4"].m_rif_id, 0x6000000000001u);
+
+    EXPECT_FALSE(getPort(portList, "Ethernet1", port));
+    EXPECT_EQ(findPort(portList, "Ethernet1"), nullptr);
+}
+
+TEST(portlookup, find_is_faster_than_get)
+{
+    const size_t lookups = 20000;
+    auto portList = makePortList(64, 20);
+    vector<string> aliases = { "PortChannel0001", "Vlan1000", "Ethernet128" };
+
+    size_t hits = 0;
+    auto start = chrono::steady_clock::now();
+    for (size_t i = 0; i < lookups; i++)
+    {
+        Port port;
+        if (getPort(portList, aliases[i % aliases.size()], port))
+        {
+            hits += port.m_members.size() + port.m_queue_ids.size();
+        }
+    }
+    auto getTime = chrono::steady_clock::now() - start;
+
+    start = chrono::steady_clock::now();
+    for (size_t i = 0; i < lookups; i++)
+    {
+        Port *port = findPort(portList, aliases[i % aliases.size()]);
+        if (port)
+        {
+            hits -= port->m_members.size() + port->m_queue_ids.size();
+        }
+    }
+    auto findTime = chrono::steady_clock::now() - start;
+
+    cout << "getPort: " << chrono::duration_cast<chrono::microseconds>(getTime).count() << " us, "
+         << "findPort: " << chrono::duration_cast<chrono::microseconds>(findTime).count() << " us "
+         << "for " << lookups << " lookups" << endl;
+
+    EXPECT_EQ(hits, 0u);
+    EXPECT_LT(findTime, getTime);
+}